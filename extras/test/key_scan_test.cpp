@@ -0,0 +1,150 @@
+/*
+ * JsonStreamHelper::scanKey split test.
+ *
+ * The listResponses and watches payloads are scanned whole, split in two at every offset, one byte
+ * at a time and in random chunks. Every split must give the same value list as the whole payload.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "GForms_KeyScan.h"
+
+static unsigned long rand_state = 1;
+static unsigned long checks = 0;
+static unsigned long failures = 0;
+
+static unsigned int next_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (unsigned int)(rand_state >> 16) & 0x7fff;
+}
+
+// Scan the chunks ending at the cut offsets, each chunk in its own exact sized buffer
+static void check_chunks(const char *name, const char *key, const char *payload, const size_t *cuts, size_t count, const char *expected)
+{
+    gforms_key_scan_state_t state;
+    MB_String out;
+    size_t start = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t len = cuts[i] - start;
+        char *chunk = (char *)malloc(len > 0 ? len : 1);
+        memcpy(chunk, payload + start, len);
+        JsonStreamHelper::scanKey(state, key, strlen(key), chunk, len, out);
+        free(chunk);
+        start = cuts[i];
+    }
+
+    checks++;
+    if (strcmp(out.c_str(), expected) != 0)
+    {
+        failures++;
+        if (failures <= 10)
+            printf("FAIL %s (key %s, first cut %u)\n  expected: %s\n  scanned:  %s\n", name, key, count > 1 ? (unsigned int)cuts[0] : 0, expected, out.c_str());
+    }
+}
+
+static void check_payload(const char *key, const char *payload, const char *expected)
+{
+    size_t len = strlen(payload);
+    size_t *cuts = (size_t *)malloc((len + 1) * sizeof(size_t));
+
+    cuts[0] = len;
+    check_chunks("whole", key, payload, cuts, 1, expected);
+
+    for (size_t i = 0; i <= len; i++)
+    {
+        cuts[0] = i;
+        cuts[1] = len;
+        check_chunks("split", key, payload, cuts, 2, expected);
+    }
+
+    for (size_t i = 0; i < len; i++)
+        cuts[i] = i + 1;
+    check_chunks("bytes", key, payload, cuts, len, expected);
+
+    for (int round = 0; round < 200; round++)
+    {
+        size_t offset = 0, count = 0;
+        while (offset < len)
+        {
+            offset += 1 + next_rand() % 64;
+            cuts[count++] = offset < len ? offset : len;
+        }
+        check_chunks("random chunks", key, payload, cuts, count, expected);
+    }
+
+    free(cuts);
+}
+
+int main(void)
+{
+    // listResponses as the server formats it, with the key also inside the answer values
+    const char *responses =
+        "{\n"
+        "  \"responses\": [\n"
+        "    {\n"
+        "      \"responseId\": \"ACYDBNj1pGZ3xKd5nT8q\",\n"
+        "      \"createTime\": \"2023-05-09T10:00:00.000Z\",\n"
+        "      \"lastSubmittedTime\": \"2023-05-09T10:00:00.000Z\",\n"
+        "      \"answers\": {\n"
+        "        \"4e6b2a10\": {\n"
+        "          \"questionId\": \"4e6b2a10\",\n"
+        "          \"textAnswers\": {\n"
+        "            \"answers\": [\n"
+        "              {\n"
+        "                \"value\": \"the \\\"responseId\\\": \\\"not this one\\\"\"\n"
+        "              },\n"
+        "              {\n"
+        "                \"value\": \"responseId\"\n"
+        "              }\n"
+        "            ]\n"
+        "          }\n"
+        "        }\n"
+        "      }\n"
+        "    },\n"
+        "    {\n"
+        "      \"responseId\" : \"ACYDBNh2\\\"quoted\\\\\",\n"
+        "      \"createTime\": \"2023-05-09T11:00:00.000Z\",\n"
+        "      \"answers\": {\"responseIds\": {\"value\": \"responseId\"}, \"xresponseId\": \"x\"}\n"
+        "    },\n"
+        "    {\n"
+        "      \"responseId\": \"\",\n"
+        "      \"totalScore\": 3\n"
+        "    },\n"
+        "    {\n"
+        "      \"responseId\":\t12,\n"
+        "      \"responseId\":\"ACYDBNk3\"\n"
+        "    }\n"
+        "  ],\n"
+        "  \"nextPageToken\": \"ACYDBNi_responseId\"\n"
+        "}\n";
+
+    const char *watches =
+        "{\n"
+        "  \"watches\": [\n"
+        "    {\n"
+        "      \"id\": \"6f3d8c1e-9a0b-4e53-b2f1-7c1a2d3e4f50\",\n"
+        "      \"target\": {\"topic\": {\"topicName\": \"projects/my-project/topics/id\"}},\n"
+        "      \"eventType\": \"RESPONSES\",\n"
+        "      \"createTime\": \"2023-05-09T10:00:00.000Z\",\n"
+        "      \"expireTime\": \"2023-05-16T10:00:00.000Z\",\n"
+        "      \"state\": \"ACTIVE\"\n"
+        "    },\n"
+        "    {\n"
+        "      \"id\": \"0a1b2c3d\",\n"
+        "      \"eventType\": \"SCHEMA\",\n"
+        "      \"errorType\": \"id\"\n"
+        "    }\n"
+        "  ]\n"
+        "}\n";
+
+    check_payload("responseId", responses, "ACYDBNj1pGZ3xKd5nT8q,ACYDBNh2\"quoted\\,ACYDBNk3");
+    check_payload("id", watches, "6f3d8c1e-9a0b-4e53-b2f1-7c1a2d3e4f50,0a1b2c3d");
+
+    printf("%s: JsonStreamHelper::scanKey splits (%lu checks, %lu failures)\n", failures == 0 ? "PASS" : "FAIL", checks, failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,279 @@
+/*
+ * Differential test of the MB_JSON string and whitespace scanning (MB_JSON_FAST_SCAN).
+ *
+ * Every case prints its parse result. run_tests.sh builds this file with each scan variant
+ * (SSE2/NEON, word at a time, word at a time without ctz) and compares the output with the
+ * byte by byte build (MB_JSON_FAST_SCAN=0).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MB_JSON.h"
+
+static unsigned long rand_state = 1;
+
+static unsigned int next_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (unsigned int)(rand_state >> 16) & 0x7fff;
+}
+
+static void print_tree(MB_JSON *json)
+{
+    char *out = MB_JSON_PrintUnformatted(json);
+    printf("ok %s\n", out ? out : "(print failed)");
+    free(out);
+    MB_JSON_Delete(json);
+}
+
+/* Parse the text from an exact sized buffer that starts align bytes into the block, so an over-read past the end is reported */
+static void run(const char *name, const char *text, size_t len, size_t align)
+{
+    const char *end = NULL;
+    char *block = (char *)malloc(align + len);
+    char *value = block + align;
+    MB_JSON *json;
+
+    memcpy(value, text, len);
+
+    printf("%s/%u: ", name, (unsigned int)align);
+    json = MB_JSON_ParseWithLengthOpts(value, len, &end, 0);
+    if (json)
+    {
+        printf("end %d ", (int)(end - value));
+        print_tree(json);
+    }
+    else
+    {
+        printf("err %d\n", (int)(end - value));
+    }
+
+    free(block);
+
+    /* the in situ parse needs the terminator */
+    block = (char *)malloc(align + len + 1);
+    value = block + align;
+    memcpy(value, text, len);
+    value[len] = '\0';
+
+    printf("%s/%u in situ: ", name, (unsigned int)align);
+    json = MB_JSON_ParseInSitu(value, &end, 0, NULL);
+    if (json)
+    {
+        printf("end %d ", (int)(end - value));
+        print_tree(json);
+    }
+    else
+    {
+        printf("err %d\n", (int)(end - value));
+    }
+
+    free(block);
+}
+
+/* Strings of every length up to 48 with one special sequence at every position */
+static void test_strings(void)
+{
+    static const char *specials[] = {"\\\"", "\\\\", "\\n", "\\/", "\\u00e9", "\\ud83d\\ude00", "\xc3\xa9", "\"", "\\", "\x01", "\x7f", "\xff"};
+    char body[64];
+    char doc[256];
+    char name[64];
+    size_t n, pos, s;
+
+    for (n = 0; n <= 48; n++)
+    {
+        for (pos = 0; pos <= n; pos++)
+        {
+            for (s = 0; s < sizeof(specials) / sizeof(specials[0]); s++)
+            {
+                memset(body, 'a' + (int)(n % 26), n);
+                body[n] = '\0';
+                memmove(body + pos + strlen(specials[s]), body + pos, n - pos + 1);
+                memcpy(body + pos, specials[s], strlen(specials[s]));
+                sprintf(doc, "{\"k%s\":\"%s\",\"a\":[\"%s\"]}", body, body, body);
+                sprintf(name, "string %u %u %u", (unsigned int)n, (unsigned int)pos, (unsigned int)s);
+                run(name, doc, strlen(doc), (n + pos) % 16);
+            }
+        }
+    }
+}
+
+/* Whitespace runs of every length up to 40 before and between the tokens */
+static void test_spaces(void)
+{
+    static const char *runs[] = {" ", "\t", "\r\n", " \t\n\r"};
+    static const char *tokens[] = {"[", "1", ",", "\"a b\"", ",", "{", "\"b\"", ":", "null", "}", "]"};
+    static const char stops[] = {'\0', '!', '\x7f', '\x80', '\xff'};
+    char doc[2048];
+    char name[64];
+    size_t n, r, t, i, s;
+
+    for (n = 0; n <= 40; n++)
+    {
+        for (r = 0; r < sizeof(runs) / sizeof(runs[0]); r++)
+        {
+            for (s = 0; s < sizeof(stops); s++)
+            {
+                size_t len = 0;
+                for (t = 0; t < sizeof(tokens) / sizeof(tokens[0]); t++)
+                {
+                    for (i = 0; i < n; i++)
+                    {
+                        doc[len++] = runs[r][i % strlen(runs[r])];
+                    }
+                    memcpy(doc + len, tokens[t], strlen(tokens[t]));
+                    len += strlen(tokens[t]);
+                }
+                for (i = 0; i < n; i++)
+                {
+                    doc[len++] = runs[r][i % strlen(runs[r])];
+                }
+                /* the byte after the trailing run */
+                if (stops[s] != '\0')
+                {
+                    doc[len++] = stops[s];
+                }
+                sprintf(name, "space %u %u %u", (unsigned int)n, (unsigned int)r, (unsigned int)s);
+                run(name, doc, len, n % 16);
+            }
+        }
+    }
+}
+
+/* Every prefix of a document with long strings and indentation, at every alignment */
+static void test_prefixes(void)
+{
+    const char *doc = "{\n    \"responses\": [\n        {\n            \"responseId\": \"ACYDBNi84NuJlKdpMnPJ\\\"quoted\\\" and \\\\back\\\\slashes\",\n"
+                      "            \"answers\": {\"text\": \"long plain answer text with enough characters to span several words and vectors\"},\n"
+                      "            \"utf8\": \"\xe0\xb8\x97\xe0\xb8\x94\xe0\xb8\xaa\xe0\xb8\xad\xe0\xb8\x9a \\u0e17\\u0e14\"\n        }\n    ]\n}\n";
+    char name[64];
+    size_t len = strlen(doc);
+    size_t i, align;
+
+    for (i = 0; i <= len; i++)
+    {
+        sprintf(name, "prefix %u", (unsigned int)i);
+        run(name, doc, i, i % 16);
+    }
+
+    for (align = 0; align < 16; align++)
+    {
+        run("aligned", doc, len, align);
+    }
+}
+
+static void random_string(char *out, size_t *len)
+{
+    static const char *pieces[] = {"a", "plain", " ", "\\\"", "\\\\", "\\t", "\\u0041", "\xc3\xa9", "0123456789abcdef"};
+    size_t count = next_rand() % 12;
+    size_t i;
+
+    out[(*len)++] = '\"';
+    for (i = 0; i < count; i++)
+    {
+        const char *piece = pieces[next_rand() % (sizeof(pieces) / sizeof(pieces[0]))];
+        memcpy(out + *len, piece, strlen(piece));
+        *len += strlen(piece);
+    }
+    out[(*len)++] = '\"';
+}
+
+static void random_space(char *out, size_t *len)
+{
+    static const char spaces[] = {' ', '\t', '\n', '\r'};
+    size_t count = next_rand() % 4 == 0 ? next_rand() % 24 : 0;
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        out[(*len)++] = spaces[next_rand() % sizeof(spaces)];
+    }
+}
+
+static void random_value(char *out, size_t *len, int depth)
+{
+    unsigned int kind = depth > 3 ? next_rand() % 3 : next_rand() % 5;
+    size_t count, i;
+
+    random_space(out, len);
+    switch (kind)
+    {
+    case 0:
+        random_string(out, len);
+        break;
+    case 1:
+        *len += (size_t)sprintf(out + *len, "%d", (int)(next_rand() % 2000) - 1000);
+        break;
+    case 2:
+        memcpy(out + *len, "true", 4);
+        *len += 4;
+        break;
+    case 3:
+        out[(*len)++] = '[';
+        count = next_rand() % 4;
+        for (i = 0; i < count; i++)
+        {
+            if (i > 0)
+            {
+                out[(*len)++] = ',';
+            }
+            random_value(out, len, depth + 1);
+        }
+        random_space(out, len);
+        out[(*len)++] = ']';
+        break;
+    default:
+        out[(*len)++] = '{';
+        count = next_rand() % 4;
+        for (i = 0; i < count; i++)
+        {
+            if (i > 0)
+            {
+                out[(*len)++] = ',';
+            }
+            random_space(out, len);
+            random_string(out, len);
+            random_space(out, len);
+            out[(*len)++] = ':';
+            random_value(out, len, depth + 1);
+        }
+        random_space(out, len);
+        out[(*len)++] = '}';
+        break;
+    }
+    random_space(out, len);
+}
+
+/* Random documents, a third of them with one byte replaced by a quote, backslash, space or control byte */
+static void test_random(void)
+{
+    static const char mutations[] = {'\"', '\\', ' ', '\x01', '}'};
+    char *doc = (char *)malloc(1 << 16);
+    char name[64];
+    unsigned int i;
+
+    for (i = 0; i < 3000; i++)
+    {
+        size_t len = 0;
+        random_value(doc, &len, 0);
+        if (i % 3 == 2 && len > 0)
+        {
+            doc[next_rand() % len] = mutations[next_rand() % sizeof(mutations)];
+        }
+        sprintf(name, "random %u", i);
+        run(name, doc, len, i % 16);
+    }
+
+    free(doc);
+}
+
+int main(void)
+{
+    test_strings();
+    test_spaces();
+    test_prefixes();
+    test_random();
+    return 0;
+}
@@ -0,0 +1,262 @@
+/*
+ * MB_JSON_Stream split test.
+ *
+ * Every document is fed whole, split in two at every offset, one byte at a time and in random slices.
+ * The streamed tree and the end of the JSON must match the one-shot MB_JSON_ParseWithLengthOpts.
+ * A malformed document must fail (or stay incomplete when it is cut short) in every split.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MB_JSON.h"
+
+static unsigned long rand_state = 1;
+static unsigned long checks = 0;
+static unsigned long failures = 0;
+
+static unsigned int next_rand(void)
+{
+    rand_state = rand_state * 1103515245UL + 12345UL;
+    return (unsigned int)(rand_state >> 16) & 0x7fff;
+}
+
+/* The one-shot result, the printed tree (NULL on error) and where the JSON ended */
+typedef struct
+{
+    char *printed;
+    size_t end;
+} parse_result;
+
+static parse_result parse_whole(const char *doc, size_t len)
+{
+    parse_result result = {NULL, 0};
+    const char *end = NULL;
+    MB_JSON *json = MB_JSON_ParseWithLengthOpts(doc, len, &end, 0);
+    if (json)
+    {
+        result.printed = MB_JSON_PrintUnformatted(json);
+        result.end = (size_t)(end - doc);
+        MB_JSON_Delete(json);
+    }
+    return result;
+}
+
+/* Feed the slices given by the cut offsets (ascending, ending with len) and compare with the one-shot result */
+static void check_slices(const char *name, const char *doc, size_t len, const size_t *cuts, size_t count, const parse_result *expected)
+{
+    MB_JSON_Stream *stream = MB_JSON_StreamCreate(0, 0);
+    parse_result result = {NULL, 0};
+    int status = MB_JSON_STREAM_MORE;
+    size_t start = 0;
+    size_t i;
+
+    for (i = 0; i < count && status == MB_JSON_STREAM_MORE; i++)
+    {
+        /* each slice in its own exact sized buffer, so an over-read past the slice is reported */
+        size_t slice_len = cuts[i] - start;
+        char *slice = (char *)malloc(slice_len > 0 ? slice_len : 1);
+        size_t consumed = 0;
+        memcpy(slice, doc + start, slice_len);
+        status = MB_JSON_StreamFeed(stream, slice, slice_len, &consumed);
+        free(slice);
+        if (status == MB_JSON_STREAM_DONE)
+        {
+            MB_JSON *json = MB_JSON_StreamTake(stream);
+            result.printed = MB_JSON_PrintUnformatted(json);
+            result.end = start + consumed;
+            MB_JSON_Delete(json);
+        }
+        start = cuts[i];
+    }
+
+    checks++;
+    if (expected->printed == NULL ? result.printed != NULL : (result.printed == NULL || strcmp(result.printed, expected->printed) != 0 || result.end != expected->end))
+    {
+        failures++;
+        if (failures <= 10)
+        {
+            printf("FAIL %s: %.*s\n  one-shot: %s (end %u)\n  stream:   %s (end %u)\n", name, (int)len, doc,
+                   expected->printed ? expected->printed : "error", (unsigned int)expected->end,
+                   result.printed ? result.printed : (status == MB_JSON_STREAM_MORE ? "incomplete" : "error"), (unsigned int)result.end);
+        }
+    }
+
+    free(result.printed);
+    MB_JSON_StreamDestroy(stream);
+}
+
+static void check_document(const char *doc, size_t len, int random_slices)
+{
+    parse_result expected = parse_whole(doc, len);
+    size_t *cuts = (size_t *)malloc((len + 1) * sizeof(size_t));
+    size_t i, count;
+    int round;
+
+    cuts[0] = len;
+    check_slices("whole", doc, len, cuts, 1, &expected);
+
+    for (i = 0; i <= len; i++)
+    {
+        cuts[0] = i;
+        cuts[1] = len;
+        check_slices("split", doc, len, cuts, 2, &expected);
+    }
+
+    for (i = 0; i < len; i++)
+    {
+        cuts[i] = i + 1;
+    }
+    check_slices("bytes", doc, len, cuts, len, &expected);
+
+    for (round = 0; round < random_slices; round++)
+    {
+        size_t offset = 0;
+        count = 0;
+        while (offset < len)
+        {
+            offset += 1 + next_rand() % 24;
+            cuts[count++] = offset < len ? offset : len;
+        }
+        check_slices("random slices", doc, len, cuts, count, &expected);
+    }
+
+    free(cuts);
+    free(expected.printed);
+}
+
+static void random_space(char *out, size_t *len)
+{
+    static const char spaces[] = {' ', '\t', '\n', '\r'};
+    size_t count = next_rand() % 4 == 0 ? next_rand() % 6 : 0;
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        out[(*len)++] = spaces[next_rand() % sizeof(spaces)];
+    }
+}
+
+static void random_string(char *out, size_t *len)
+{
+    static const char *pieces[] = {"a", "plain", " ", "\\\"", "\\\\", "\\/", "\\n", "\\u00e9", "\\ud83d\\ude00", "\xc3\xa9", "0123456789abcdef"};
+    size_t count = next_rand() % 6;
+    size_t i;
+
+    out[(*len)++] = '\"';
+    for (i = 0; i < count; i++)
+    {
+        const char *piece = pieces[next_rand() % (sizeof(pieces) / sizeof(pieces[0]))];
+        memcpy(out + *len, piece, strlen(piece));
+        *len += strlen(piece);
+    }
+    out[(*len)++] = '\"';
+}
+
+static void random_value(char *out, size_t *len, int depth)
+{
+    static const char *scalars[] = {"0", "-1", "42", "3.25", "-0.5e-3", "1E+2", "12345678901234567890", "true", "false", "null"};
+    unsigned int kind = depth > 3 ? next_rand() % 2 : next_rand() % 4;
+    size_t count, i;
+
+    random_space(out, len);
+    switch (kind)
+    {
+    case 0:
+        random_string(out, len);
+        break;
+    case 1:
+    {
+        const char *scalar = scalars[next_rand() % (sizeof(scalars) / sizeof(scalars[0]))];
+        memcpy(out + *len, scalar, strlen(scalar));
+        *len += strlen(scalar);
+        break;
+    }
+    case 2:
+        out[(*len)++] = '[';
+        count = next_rand() % 4;
+        for (i = 0; i < count; i++)
+        {
+            if (i > 0)
+            {
+                out[(*len)++] = ',';
+            }
+            random_value(out, len, depth + 1);
+        }
+        random_space(out, len);
+        out[(*len)++] = ']';
+        break;
+    default:
+        out[(*len)++] = '{';
+        count = next_rand() % 4;
+        for (i = 0; i < count; i++)
+        {
+            if (i > 0)
+            {
+                out[(*len)++] = ',';
+            }
+            random_space(out, len);
+            random_string(out, len);
+            random_space(out, len);
+            out[(*len)++] = ':';
+            random_value(out, len, depth + 1);
+        }
+        random_space(out, len);
+        out[(*len)++] = '}';
+        break;
+    }
+    random_space(out, len);
+}
+
+int main(void)
+{
+    static const char *documents[] = {
+        "{\"responses\":[{\"responseId\":\"ACYDBNi84NuJlKdpMnPJ\",\"createTime\":\"2023-01-01T00:00:00.000Z\",\"answers\":{\"1a2b3c\":{\"questionId\":\"1a2b3c\",\"textAnswers\":{\"answers\":[{\"value\":\"Option 1\"}]}}}}],\"nextPageToken\":\"abc\"}",
+        "  [1, -2.5e3, 0.125, true, false, null, \"x\\u00e9\\ud83d\\ude00\\\"\\\\\\/\\b\\f\\n\\r\\t\"]  trailing",
+        "{\"a\":{},\"b\":[],\"c\":[[[{}]]],\"d\":\"\",\"e\":-0,\"f\":1e308}{\"next\":1}",
+        "\"root string\" ",
+        "true ",
+        "-12.5e-1 ",
+        "[1,2,]",
+        "{\"a\" 1}",
+        "[\"unterminated",
+        "{\"a\":tru}",
+        "[01]",
+    };
+    char *doc = (char *)malloc(1 << 16);
+    size_t i;
+
+    for (i = 0; i < sizeof(documents) / sizeof(documents[0]); i++)
+    {
+        check_document(documents[i], strlen(documents[i]), 20);
+    }
+
+    /* random documents, a third of them with one byte replaced by a quote, backslash, separator or digit */
+    for (i = 0; i < 3000; i++)
+    {
+        static const char mutations[] = {'\"', '\\', ',', ':', '}', '1'};
+        size_t len = 0;
+        size_t root = 0;
+        random_value(doc, &len, 0);
+        if (i % 3 == 2)
+        {
+            doc[next_rand() % len] = mutations[next_rand() % sizeof(mutations)];
+        }
+        while (root < len && (doc[root] == ' ' || doc[root] == '\t' || doc[root] == '\n' || doc[root] == '\r'))
+        {
+            root++;
+        }
+        /* a number or literal at the root differs by design, the stream completes it only at the byte after it and rejects a malformed tail as a whole */
+        if (root < len && strchr("-0123456789tfn", doc[root]) != NULL)
+        {
+            continue;
+        }
+        check_document(doc, len, 4);
+    }
+
+    free(doc);
+
+    printf("%s: MB_JSON_Stream splits (%lu checks, %lu failures)\n", failures == 0 ? "PASS" : "FAIL", checks, failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+#!/bin/sh
+# Host tests of the JSON parser and the response key scanner, run from anywhere with a C and C++ compiler:
+#
+#     sh extras/test/run_tests.sh
+#
+# CC, CXX and CFLAGS may be overridden, e.g. CC=clang CXX=clang++ or CFLAGS="-O2" to test without the sanitizers.
+
+set -e
+
+TEST_DIR=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$TEST_DIR/../.." && pwd)
+MB_JSON_DIR="$ROOT/src/json/MB_JSON"
+OUT=${OUT:-"$TEST_DIR/build"}
+CC=${CC:-cc}
+CXX=${CXX:-c++}
+CFLAGS=${CFLAGS:-"-g -O1 -fsanitize=address,undefined -fno-sanitize-recover=all"}
+
+mkdir -p "$OUT"
+
+# MB_JSON_FAST_SCAN variants, each compared with the byte by byte scan.
+# default: SSE2 on x86, NEON on AArch64, otherwise the word at a time scan.
+scan_variant() {
+    name=$1
+    shift
+    $CC -std=c99 $CFLAGS "$@" -I "$MB_JSON_DIR" "$TEST_DIR/mb_json_scan_test.c" "$MB_JSON_DIR/MB_JSON.c" -lm -o "$OUT/scan_$name"
+    "$OUT/scan_$name" > "$OUT/scan_$name.txt"
+}
+
+scan_variant bytes -DMB_JSON_FAST_SCAN=0
+scan_variant default
+scan_variant swar -U__SSE2__ -U__ARM_NEON
+scan_variant swar_generic -U__SSE2__ -U__ARM_NEON -U__BYTE_ORDER__
+
+for name in default swar swar_generic; do
+    if ! cmp -s "$OUT/scan_bytes.txt" "$OUT/scan_$name.txt"; then
+        echo "FAIL: MB_JSON_FAST_SCAN $name differs from the byte by byte scan"
+        diff "$OUT/scan_bytes.txt" "$OUT/scan_$name.txt" | head -n 20
+        exit 1
+    fi
+done
+echo "PASS: MB_JSON_FAST_SCAN variants ($(wc -l < "$OUT/scan_bytes.txt") results)"
+
+# MB_JSON_Stream fed in slices split at every offset, against the one-shot parse, with both scans.
+for scan in 1 0; do
+    $CC -std=c99 $CFLAGS -DMB_JSON_FAST_SCAN=$scan -I "$MB_JSON_DIR" "$TEST_DIR/mb_json_stream_test.c" "$MB_JSON_DIR/MB_JSON.c" -lm -o "$OUT/stream_scan$scan"
+    "$OUT/stream_scan$scan"
+done
+
+# JsonStreamHelper::scanKey on the listResponses and watches payloads split at every offset.
+$CXX -std=c++11 $CFLAGS -I "$TEST_DIR/stub" -I "$ROOT/src" "$TEST_DIR/key_scan_test.cpp" -o "$OUT/key_scan"
+"$OUT/key_scan"
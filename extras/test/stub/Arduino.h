@@ -0,0 +1,43 @@
+/*
+ * The few Arduino core definitions that MB_String needs, for the host tests.
+ */
+
+#ifndef ARDUINO_HOST_STUB_H
+#define ARDUINO_HOST_STUB_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+class __FlashStringHelper;
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+#define F(s) FPSTR(s)
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strcat_P strcat
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define memcpy_P memcpy
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+
+class String : public std::string
+{
+public:
+    String() {}
+    String(const char *s) : std::string(s ? s : "") {}
+    String(const std::string &s) : std::string(s) {}
+};
+
+class StringSumHelper : public String
+{
+public:
+    StringSumHelper(const char *s) : String(s) {}
+};
+
+#endif
@@ -40,11 +40,16 @@ GFormsClass::GFormsClass()
 
 GFormsClass::~GFormsClass()
 {
+    // the request being read keeps the receive buffers of auth manager
+    cancelAsyncRequests();
     authMan.end();
 }
 
 void GFormsClass::auth(const char *client_email, const char *project_id, const char *private_key, const char *sa_key_file, esp_google_forms_file_storage_type storage_type, ESP8266_SPI_ETH_MODULE *eth)
 {
+    // the credentials are copied by background token refresher
+    authMan.lockToken();
+    authMan.credentialsChanged();
     config.service_account.data.client_email = client_email;
     config.service_account.data.project_id = project_id;
     config.service_account.data.private_key = private_key;
@@ -52,6 +57,7 @@ void GFormsClass::auth(const char *client_email, const char *project_id, const c
 
     config.service_account.json.path = sa_key_file;
     config.service_account.json.storage_type = (mb_fs_mem_storage_type)storage_type;
+    authMan.unlockToken();
 
     if (eth)
     {
@@ -74,6 +80,9 @@ void GFormsClass::auth(const char *client_email, const char *project_id, const c
     config.signer.tokens.token_type = token_type_oauth2_access_token;
 
     authMan.begin(&config, &mbfs, &mb_ts, &mb_ts_offset);
+
+    // The cached token will be used when the clock is ready if it is not expired
+    authMan.readTokenCache();
 }
 
 void GFormsClass::setTokenCallback(TokenStatusCallback callback)
@@ -93,12 +102,27 @@ void GFormsClass::clearAP()
 
 bool GFormsClass::checkToken()
 {
+    if (asyncQueue.size() > 0)
+    {
+        // the token request uses the connection that the queued requests are using,
+        // the async request is captured with the current token and loop renews the token before sending it
+        if (asyncCapture)
+            return config.signer.tokens.status == token_status_ready;
+
+        // the blocking request finishes the queued requests anyway
+        if (authMan.isExpired())
+            completeAsyncRequests();
+    }
+
     return authMan.tokenReady();
 }
 
 String GFormsClass::accessToken()
 {
-    return config.internal.auth_token.c_str();
+    authMan.lockToken();
+    String token = config.internal.auth_token.c_str();
+    authMan.unlockToken();
+    return token;
 }
 
 void GFormsClass::setPrerefreshSeconds(uint16_t seconds)
@@ -107,6 +131,18 @@ void GFormsClass::setPrerefreshSeconds(uint16_t seconds)
         config.signer.preRefreshSeconds = seconds;
 }
 
+void GFormsClass::keepParsedPrivateKey(bool keep)
+{
+    config.signer.keepParsedKey = keep;
+    if (!keep)
+        authMan.freeParsedKey();
+}
+
+void GFormsClass::setBackgroundTokenRefresh(bool enable)
+{
+    authMan.setBackgroundRefresh(enable);
+}
+
 bool GFormsClass::setClock(float gmtOffset)
 {
     return TimeHelper::syncClock(&authMan.ntpClient, &mb_ts, &mb_ts_offset, gmtOffset, &config);
@@ -142,7 +178,7 @@ void GFormsClass::setCert(const char *ca)
     int addr = reinterpret_cast<int>(ca);
     if (addr != cert_addr)
     {
-        cert_updated = true;
+        cert_updated = 0xff;
         cert_addr = addr;
 #if defined(ESP8266) || defined(MB_ARDUINO_PICO)
         waitClockReady();
@@ -157,7 +193,7 @@ void GFormsClass::setCertFile(const char *filename, esp_google_forms_file_storag
     cert_addr = 0;
     if (config.cert.file.length() > 0)
     {
-        cert_updated = true;
+        cert_updated = 0xff;
 
 #if defined(ESP8266) || defined(MB_ARDUINO_PICO)
         waitClockReady();
@@ -165,11 +201,24 @@ void GFormsClass::setCertFile(const char *filename, esp_google_forms_file_storag
     }
 }
 
+void GFormsClass::setTokenCacheFile(const char *filename, esp_google_forms_file_storage_type type)
+{
+    config.token_cache.file = filename;
+    config.token_cache.storage_type = (mb_fs_mem_storage_type)type;
+}
+
 void GFormsClass::reset()
 {
+    cancelAsyncRequests();
+
+    authMan.lockToken();
+    authMan.credentialsChanged();
     config.internal.client_id.clear();
     config.internal.client_secret.clear();
     config.internal.auth_token.clear();
+    config.internal.auth_token_generation++;
+    headerBlock[host_type_forms].clear();
+    headerBlock[host_type_drive].clear();
     config.internal.last_jwt_generation_error_cb_millis = 0;
     config.signer.tokens.expires = 0;
     config.internal.rtoken_requested = false;
@@ -179,9 +228,10 @@ void GFormsClass::reset()
     config.internal.password_crc = 0;
 
     config.signer.tokens.status = token_status_uninitialized;
+    authMan.unlockToken();
 }
 
-bool GFormsClass::setSecure()
+bool GFormsClass::setSecure(gforms_pool_host host)
 {
     GFORMS_TCP_Client *client = authMan.tcpClient;
 
@@ -201,7 +251,7 @@ bool GFormsClass::setSecure()
     }
 #endif
 
-    if (client->getCertType() == gforms_cert_type_undefined || cert_updated)
+    if (client->getCertType() == gforms_cert_type_undefined || (cert_updated & (1 << host)))
     {
 
         if (!config.internal.clock_rdy && (config.cert.file.length() > 0 || config.cert.data != NULL || cert_addr > 0))
@@ -221,16 +271,34 @@ bool GFormsClass::setSecure()
             if (!client->setCertFile(config.cert.file.c_str(), config.cert.file_storage))
                 client->setCACert(NULL);
         }
-        cert_updated = false;
+        cert_updated &= ~(1 << host);
     }
     return true;
 }
 
 bool GFormsClass::beginRequest(MB_String &req, host_type_t host_type)
 {
-    GFORMS_TCP_Client *client = authMan.tcpClient;
+    // the request is being captured for the async operation, it will be connected and sent in loop
+    if (asyncCapture)
+    {
+        asyncCapture->hostType = host_type;
+        return true;
+    }
+
+    // the blocking request shares the connection with the queued requests, finish them first
+    completeAsyncRequests();
+
+    return beginConnection(host_type);
+}
 
-    if (!setSecure())
+bool GFormsClass::beginConnection(host_type_t host_type)
+{
+    gforms_pool_host host = host_type == host_type_forms ? gforms_pool_host_forms : gforms_pool_host_drive;
+
+    // each host keeps its own connection
+    GFORMS_TCP_Client *client = authMan.useClient(host, true);
+
+    if (!setSecure(host))
         return false;
 
     if (client && !client->connected())
@@ -252,33 +320,62 @@ bool GFormsClass::beginRequest(MB_String &req, host_type_t host_type)
     return true;
 }
 
-void GFormsClass::addHeader(MB_String &req, host_type_t host_type, int len)
+void GFormsClass::buildHeaderBlock(host_type_t host_type)
 {
-    req += FPSTR(" HTTP/1.1\r\n");
+    MB_String &block = headerBlock[host_type];
+    block.clear();
+    block.reserve(200 + config.internal.auth_token.length());
+    block += FPSTR(" HTTP/1.1\r\n");
     if (host_type == host_type_forms)
-        req += FPSTR("Host: forms.googleapis.com\r\n");
+        block += FPSTR("Host: forms.googleapis.com\r\n");
     else if (host_type == host_type_drive)
-        req += FPSTR("Host: www.googleapis.com\r\n");
-    req += FPSTR("Authorization: Bearer ");
-    req += config.internal.auth_token;
-    req += FPSTR("\r\n");
+        block += FPSTR("Host: www.googleapis.com\r\n");
+    block += FPSTR("Authorization: Bearer ");
+    block += config.internal.auth_token;
+    block += FPSTR("\r\n");
+    block += FPSTR("Connection: keep-alive\r\n");
+    block += FPSTR("Keep-Alive: timeout=30, max=100\r\n");
+    block += FPSTR("Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n");
+}
+
+void GFormsClass::addHeader(MB_String &req, host_type_t host_type, int len)
+{
+    // rebuild the header blocks only when the token was changed (the token may be swapped by background refresher)
+    authMan.lockToken();
+    if (headerBlock[host_type].length() == 0 || headerBlockGeneration != config.internal.auth_token_generation)
+    {
+        buildHeaderBlock(host_type_forms);
+        buildHeaderBlock(host_type_drive);
+        headerBlockGeneration = config.internal.auth_token_generation;
+    }
+    authMan.unlockToken();
+
+    MB_String &block = headerBlock[host_type];
+
+    req.reserve(req.length() + block.length() + 70);
+    req += block;
 
     if (len > -1)
     {
         req += FPSTR("Content-Length: ");
         req += len;
-        req += FPSTR("\r\n");
-
-        req += FPSTR("Content-Type: application/json\r\n");
+        req += FPSTR("\r\nContent-Type: application/json\r\n");
     }
-
-    req += FPSTR("Connection: keep-alive\r\n");
-    req += FPSTR("Keep-Alive: timeout=30, max=100\r\n");
-    req += FPSTR("Accept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n");
 }
 
-bool GFormsClass::processRequest(MB_String &req, MB_String &response, int &httpcode, const char *key)
+bool GFormsClass::processRequest(MB_String &req, MB_String &response, int &httpcode, const char *key, gforms_json_stream_state_t *stream, FirebaseJson *body)
 {
+    // capture the request for the async operation
+    if (asyncCapture)
+    {
+        asyncCapture->req.move(req);
+        if (body)
+            asyncCapture->req += body->raw();
+        asyncCapture->key = key;
+        asyncCapture->tokenGeneration = headerBlockGeneration;
+        return true;
+    }
+
     GFORMS_TCP_Client *client = authMan.tcpClient;
 
     if (!client)
@@ -288,11 +385,15 @@ bool GFormsClass::processRequest(MB_String &req, MB_String &response, int &httpc
 
     int ret = client->send(req.c_str());
     req.clear();
+
+    // serialize the body straight to the client
+    if (ret > 0 && body && !body->toString(*client))
+        ret = client->setError(GFORMS_ERROR_TCP_ERROR_SEND_REQUEST_FAILED);
     config.signer.tokens.error.message.clear();
 
     if (ret > 0)
     {
-        ret = authMan.handleResponse(client, httpcode, response, key, false);
+        ret = authMan.handleResponse(client, httpcode, response, key, false, stream);
         if (!ret)
         {
             authMan.response_code = httpcode;
@@ -318,6 +419,270 @@ bool GFormsClass::processRequest(MB_String &req, MB_String &response, int &httpc
     return ret > 0;
 }
 
+bool GFormsClass::beginAsync(gforms_async_request_t *request, GFORMS_AsyncCallback callback)
+{
+    // the request is still in the queue or the other request is being captured
+    if (!request || asyncCapture || (request->state != gforms_async_state_idle && !request->ready()))
+        return false;
+
+    request->state = gforms_async_state_idle;
+    request->httpCode = 0;
+    request->success = false;
+    request->payload.clear();
+    request->req.clear();
+    request->key.clear();
+    request->shareEmail.clear();
+    request->createResponse.clear();
+    request->callback = callback;
+
+    asyncCapture = request;
+
+    return true;
+}
+
+bool GFormsClass::endAsync(gforms_async_request_t *request, bool ret)
+{
+    asyncCapture = nullptr;
+
+    if (!ret)
+    {
+        request->state = gforms_async_state_error;
+        request->httpCode = authMan.response_code;
+        return false;
+    }
+
+    request->state = gforms_async_state_connect;
+    asyncQueue.push_back(request);
+
+    return true;
+}
+
+bool GFormsClass::processAsync(gforms_async_request_t *request)
+{
+    GFORMS_TCP_Client *client = authMan.tcpClient;
+
+    if (!client)
+    {
+        request->state = gforms_async_state_error;
+        return true;
+    }
+
+    switch (request->state)
+    {
+    case gforms_async_state_connect:
+
+        if (!beginConnection((host_type_t)request->hostType))
+        {
+            request->httpCode = GFORMS_ERROR_TCP_ERROR_CONNECTION_REFUSED;
+            request->state = gforms_async_state_error;
+            return true;
+        }
+
+        request->state = gforms_async_state_send;
+        return false;
+
+    case gforms_async_state_send:
+    {
+        authMan.response_code = 0;
+        config.signer.tokens.error.message.clear();
+
+        int ret = client->send(request->req.c_str());
+        request->req.clear();
+
+        request->reader = gforms_response_reader_t();
+
+        if (ret > 0 && !authMan.beginResponse(client, request->reader, request->key.c_str(), nullptr))
+            ret = GFORMS_ERROR_TCP_ERROR_CONNECTION_LOST;
+
+        if (ret <= 0)
+        {
+            request->httpCode = ret;
+            request->state = gforms_async_state_error;
+            return true;
+        }
+
+        request->state = gforms_async_state_response;
+        return false;
+    }
+
+    case gforms_async_state_response:
+    {
+        // read the available data only, the remaining data will be read in the next loop
+        int ret = authMan.readResponse(client, request->reader, request->payload, GFORMS_ASYNC_READS_PER_LOOP);
+
+        if (ret == 0)
+            return false;
+
+        if (ret < 0 && !request->reader.started)
+        {
+            authMan.freeResponse(request->reader);
+            request->httpCode = GFORMS_ERROR_TCP_ERROR_CONNECTION_LOST;
+            request->state = gforms_async_state_error;
+            return true;
+        }
+
+        bool ok = authMan.completeResponse(client, request->reader, request->httpCode, request->payload, false);
+        request->state = ok ? gforms_async_state_complete : gforms_async_state_error;
+        return true;
+    }
+
+    default:
+        return true;
+    }
+}
+
+void GFormsClass::completeAsync(gforms_async_request_t *request)
+{
+    bool ok = request->state == gforms_async_state_complete;
+
+    if (!ok)
+    {
+        // the same as processRequest
+        authMan.response_code = request->httpCode;
+        if (request->httpCode > 0)
+        {
+            FirebaseJson json(request->payload);
+            FirebaseJsonData result;
+            json.get(result, "error/message");
+            if (result.success)
+                config.signer.tokens.error.message = result.stringValue;
+            else
+                config.signer.tokens.error.message = request->payload;
+        }
+
+        if (authMan.tcpClient)
+            authMan.tcpClient->stop();
+    }
+    else if (request->payload.length() > 0)
+        ok = !isError(request->payload);
+
+    // the created form is shared with the user by the next request
+    if (request->shareEmail.length() > 0)
+    {
+        MB_String formId;
+        if (ok)
+            formId = authMan.getValue(request->payload, (const char *)FPSTR("formId"));
+
+        if (formId.length() > 0)
+        {
+            MB_String email, res;
+            email.move(request->shareEmail);
+            request->createResponse.move(request->payload);
+
+            // this can be called while the other request is being captured
+            gforms_async_request_t *capture = asyncCapture;
+            asyncCapture = request;
+            bool ret = createPermission(res, formId.c_str(), (const char *)FPSTR("writer"), (const char *)FPSTR("user"), email.c_str());
+            asyncCapture = capture;
+
+            if (ret)
+            {
+                request->state = gforms_async_state_connect;
+                asyncQueue.insert(asyncQueue.begin(), request);
+                return;
+            }
+
+            ok = false;
+        }
+    }
+    else if (request->createResponse.length() > 0)
+    {
+        // the permission request was done, returns the form creation response
+        request->payload.move(request->createResponse);
+    }
+
+    request->success = ok;
+    if (request->state == gforms_async_state_complete && !ok)
+        request->state = gforms_async_state_error;
+
+    if (request->callback)
+        request->callback(request);
+}
+
+void GFormsClass::updateAsyncToken(gforms_async_request_t *request)
+{
+    authMan.lockToken();
+    if (request->tokenGeneration != config.internal.auth_token_generation)
+    {
+        MB_String auth = FPSTR("Authorization: Bearer ");
+        size_t p = request->req.find(auth);
+        size_t e = p != MB_String::npos ? request->req.find((const char *)FPSTR("\r\n"), p) : MB_String::npos;
+        if (e != MB_String::npos)
+        {
+            p += auth.length();
+            request->req.erase(p, e - p);
+            request->req.replace(p, 0, config.internal.auth_token.c_str());
+        }
+        request->tokenGeneration = config.internal.auth_token_generation;
+    }
+    authMan.unlockToken();
+}
+
+void GFormsClass::loop()
+{
+    if (asyncQueue.size() == 0)
+        return;
+
+    gforms_async_request_t *request = asyncQueue[0];
+
+    if (request->state == gforms_async_state_connect)
+    {
+        // no request is being read, the new request is held back until the token was renewed
+        // as the token request uses the same connection
+        if (authMan.isExpired() && !authMan.tokenReady())
+            return;
+
+        updateAsyncToken(request);
+    }
+
+    if (processAsync(request))
+    {
+        // removed before the callback which can start the other requests
+        asyncQueue.erase(asyncQueue.begin());
+        completeAsync(request);
+    }
+}
+
+void GFormsClass::completeAsyncRequests()
+{
+    while (asyncQueue.size() > 0)
+    {
+        loop();
+        Utils::idle();
+    }
+}
+
+void GFormsClass::cancelAsyncRequests()
+{
+    bool started = false;
+
+    for (size_t i = 0; i < asyncQueue.size(); i++)
+    {
+        gforms_async_request_t *request = asyncQueue[i];
+
+        // the request being read owns the receive and chunk buffers
+        if (request->state == gforms_async_state_send || request->state == gforms_async_state_response)
+        {
+            if (request->state == gforms_async_state_response)
+                authMan.freeResponse(request->reader);
+            started = true;
+        }
+
+        request->req.clear();
+        request->shareEmail.clear();
+        request->createResponse.clear();
+        request->httpCode = GFORMS_ERROR_ASYNC_REQUEST_CANCELLED;
+        request->success = false;
+        request->state = gforms_async_state_error;
+    }
+
+    asyncQueue.clear();
+
+    // the connection of the started request can't be used by the next request
+    if (started && authMan.tcpClient)
+        authMan.tcpClient->stop();
+}
+
 bool GFormsClass::create(MB_String &response, const char *title, const char *docTitle)
 {
     if (!checkToken())
@@ -381,12 +746,11 @@ bool GFormsClass::createPermission(MB_String &response, const char *fileid, cons
     js.add((const char *)FPSTR("type"), type);
     js.add((const char *)FPSTR("emailAddress"), email);
 
-    addHeader(req, host_type_drive, strlen(js.raw()));
+    addHeader(req, host_type_drive, js.serializedBufferLength());
 
     req += FPSTR("\r\n");
-    req += js.raw();
 
-    bool ret = processRequest(req, response, httpcode);
+    bool ret = processRequest(req, response, httpcode, "", nullptr, &js);
 
     return ret;
 }
@@ -409,11 +773,10 @@ bool GFormsClass::batchUpdate(MB_String &response, const char *formId, FirebaseJ
 
     if (request)
     {
-        addHeader(req, host_type_forms, strlen(request->raw()));
+        addHeader(req, host_type_forms, request->serializedBufferLength());
         req += FPSTR("\r\n");
-        req += request->raw();
 
-        return processRequest(req, response, httpcode);
+        return processRequest(req, response, httpcode, "", nullptr, request);
     }
 
     return false;
@@ -440,7 +803,7 @@ bool GFormsClass::getForm(MB_String &response, const char *formId)
     return processRequest(req, response, httpcode);
 }
 
-bool GFormsClass::listResponses(MB_String &response, const char *formId, const char *key, const char *filter, int pageSize, const char *pageToken)
+bool GFormsClass::listResponses(MB_String &response, const char *formId, const char *key, const char *filter, int pageSize, const char *pageToken, GFORMS_JsonStreamCallback streamCallback)
 {
     if (!checkToken())
         return false;
@@ -482,6 +845,13 @@ bool GFormsClass::listResponses(MB_String &response, const char *formId, const c
 
     req += FPSTR("\r\n");
 
+    if (streamCallback)
+    {
+        gforms_json_stream_state_t stream;
+        JsonStreamHelper::begin(stream, streamCallback);
+        return processRequest(req, response, httpcode, key, &stream);
+    }
+
     return processRequest(req, response, httpcode, key);
 }
 
@@ -508,6 +878,91 @@ bool GFormsClass::getResponse(MB_String &response, const char *formId, const cha
     return processRequest(req, response, httpcode, "");
 }
 
+bool GFormsClass::getResponses(const char *formId, const std::vector<String> &responseIds, std::vector<String> *responses, GFORMS_ResponseItemCallback callback)
+{
+    if (!checkToken())
+        return false;
+
+    MB_String req, response;
+
+    if (!beginRequest(req, host_type_forms))
+        return false;
+
+    GFORMS_TCP_Client *client = authMan.tcpClient;
+
+    if (!client)
+        return false;
+
+    authMan.response_code = 0;
+    config.signer.tokens.error.message.clear();
+
+    // keep the receive and chunk buffers that may hold the next responses for all items
+    authMan.beginPipeline();
+
+    size_t count = responseIds.size(), sent = 0, received = 0;
+    bool ret = true;
+
+    while (received < count)
+    {
+        // send the next requests ahead of their responses on the keep-alive connection
+        while (sent < count && sent - received < GFORMS_PIPELINE_DEPTH)
+        {
+            req = FPSTR("GET /v1/forms/");
+            req += formId;
+            req += FPSTR("/responses/");
+            req += responseIds[sent].c_str();
+
+            addHeader(req, host_type_forms);
+
+            req += FPSTR("\r\n");
+
+            if (client->send(req.c_str()) <= 0)
+                break;
+            sent++;
+        }
+
+        req.clear();
+
+        // send failed
+        if (sent == received)
+        {
+            ret = false;
+            break;
+        }
+
+        // read the responses in the order of requests
+        int httpcode = 0;
+        response.clear();
+        if (!authMan.handleResponse(client, httpcode, response, "", false))
+        {
+            ret = false;
+            authMan.response_code = httpcode;
+
+            // connection lost, the remaining responses will never come
+            if (httpcode <= 0)
+                break;
+
+            FirebaseJson json(response);
+            FirebaseJsonData result;
+            json.get(result, "error/message");
+            config.signer.tokens.error.message = result.success ? result.stringValue : response;
+        }
+
+        if (callback)
+            callback(received, responseIds[received].c_str(), httpcode, response.c_str());
+        if (responses)
+            responses->push_back(response.c_str());
+        received++;
+    }
+
+    authMan.endPipeline();
+
+    if (received < count)
+        client->stop();
+
+    return ret;
+}
+
 bool GFormsClass::createWatch(MB_String &response, const char *formId, FirebaseJson *request)
 {
     if (!checkToken())
@@ -525,11 +980,10 @@ bool GFormsClass::createWatch(MB_String &response, const char *formId, FirebaseJ
 
     if (request)
     {
-        addHeader(req, host_type_forms, strlen(request->raw()));
+        addHeader(req, host_type_forms, request->serializedBufferLength());
         req += FPSTR("\r\n");
-        req += request->raw();
 
-        return processRequest(req, response, httpcode);
+        return processRequest(req, response, httpcode, "", nullptr, request);
     }
 
     return false;
@@ -70,7 +70,17 @@ private:
     int response_code = 0;
 
     int cert_addr = 0;
-    bool cert_updated = false;
+    // the pooled connections (bit of gforms_pool_host) that the certificate should be updated
+    uint8_t cert_updated = 0;
+
+    // the prebuilt header lines per host for the token of headerBlockGeneration
+    MB_String headerBlock[2];
+    uint32_t headerBlockGeneration = 0;
+
+    // the async requests in order of sending, the front request is being processed
+    MB_VECTOR<gforms_async_request_t *> asyncQueue;
+    // the async request that the request functions are being captured into instead of sending
+    gforms_async_request_t *asyncCapture = nullptr;
 
     void auth(const char *client_email, const char *project_id, const char *private_key, const char *sa_key_file, esp_google_forms_file_storage_type storage_type, ESP8266_SPI_ETH_MODULE *eth = nullptr);
     void setTokenCallback(TokenStatusCallback callback);
@@ -79,32 +89,49 @@ private:
     bool checkToken();
     String accessToken();
     void setPrerefreshSeconds(uint16_t seconds);
+    void keepParsedPrivateKey(bool keep);
+    void setBackgroundTokenRefresh(bool enable);
     bool isError(MB_String &response);
 
     bool beginRequest(MB_String &req, host_type_t host_type);
+    bool beginConnection(host_type_t host_type);
+    void buildHeaderBlock(host_type_t host_type);
     void addHeader(MB_String &req, host_type_t host_type, int len = -1);
-    bool processRequest(MB_String &req, MB_String &response, int &httpcode, const char *key = "");
+    bool processRequest(MB_String &req, MB_String &response, int &httpcode, const char *key = "", gforms_json_stream_state_t *stream = nullptr, FirebaseJson *body = nullptr);
     bool create(MB_String &response, const char *title, const char *docTitle = "");
     bool createPermission(MB_String &response, const char *fileId, const char *role, const char *type, const char *email);
     bool batchUpdate(MB_String &response, const char *formId, FirebaseJson *request);
     bool getForm(MB_String &response, const char *formId);
-    bool listResponses(MB_String &response, const char *formId, const char *key = "", const char *filter = "", int pageSize = 0, const char *pageToken = "");
+    bool listResponses(MB_String &response, const char *formId, const char *key = "", const char *filter = "", int pageSize = 0, const char *pageToken = "", GFORMS_JsonStreamCallback streamCallback = NULL);
     bool getResponse(MB_String &response, const char *formId, const char *responseId);
+    bool getResponses(const char *formId, const std::vector<String> &responseIds, std::vector<String> *responses, GFORMS_ResponseItemCallback callback = NULL);
     bool createWatch(MB_String &response, const char *formId, FirebaseJson *request);
     bool listWatch(MB_String &response, const char *formId, const char *key);
     bool deleteWatch(MB_String &response, const char *formId, const char *watchId);
     bool listWatches(MB_String &response, const char *formId);
     bool renewWatch(MB_String &response, const char *formId, const char *watchId);
 
+    bool beginAsync(gforms_async_request_t *request, GFORMS_AsyncCallback callback);
+    bool endAsync(gforms_async_request_t *request, bool ret);
+    /* process the next step of request, returns true when the request was finished */
+    bool processAsync(gforms_async_request_t *request);
+    void completeAsync(gforms_async_request_t *request);
+    /* replace the token in the queued request when the token was renewed after it was captured */
+    void updateAsyncToken(gforms_async_request_t *request);
+    void loop();
+    void completeAsyncRequests();
+    void cancelAsyncRequests();
+
     bool setClock(float gmtOffset);
 #if defined(ESP_GOOGLE_FORMS_CLIENT_ENABLE_EXTERNAL_CLIENT)
     void setClient(Client *client, GFORMS_NetworkConnectionRequestCallback networkConnectionCB,
                    GFORMS_NetworkStatusRequestCallback networkStatusCB);
     void setUDPClient(UDP *client, float gmtOffset = 0);
 #endif
-    bool setSecure();
+    bool setSecure(gforms_pool_host host);
     void setCert(const char *ca);
     void setCertFile(const char *filename, esp_google_forms_file_storage_type type);
+    void setTokenCacheFile(const char *filename, esp_google_forms_file_storage_type type);
     void reset();
     bool waitClockReady();
 };
@@ -164,6 +191,16 @@ public:
     template <typename T = const char *>
     void setCertFile(T filename, esp_google_forms_file_storage_type storageType) { gforms->setCertFile(toString(filename), storageType); }
 
+    /** Set the file to keep the access token for reuse after device restarted.
+     * @param filename The token cache file name incuded path.
+     * @param storageType The storage type of token cache file. esp_google_forms_file_storage_type_flash or esp_google_forms_file_storage_type_sd
+     *
+     * @note This should be called before begin. The cached token is used only when it was issued
+     * for the same service account and is not expired.
+     */
+    template <typename T = const char *>
+    void setTokenCacheFile(T filename, esp_google_forms_file_storage_type storageType) { gforms->setTokenCacheFile(toString(filename), storageType); }
+
     /** Set the OAuth2.0 token generation status callback.
      *
      * @param callback The callback function that accepts the TokenInfo as argument.
@@ -257,6 +294,32 @@ public:
         gforms->setPrerefreshSeconds(seconds);
     }
 
+    /** Keep the parsed private key in memory for the next token signing.
+     *
+     * @param keep The boolean option to keep the parsed key. Default is false.
+     *
+     * @note The private key PEM parsing is skipped in the next token refreshes and the PEM
+     * text from service account file will not be kept, but the parsed key uses memory while it is kept.
+     *
+     */
+    void keepParsedPrivateKey(bool keep)
+    {
+        gforms->keepParsedPrivateKey(keep);
+    }
+
+    /** Renew the auth token in background before it expires.
+     *
+     * @param enable The boolean option to enable the background token refresher. Default is false.
+     *
+     * @note ESP32 only and not available with the external Client. The token is renewed by a FreeRTOS task
+     * with its own SSL client in the pre-refresh period, the current token is used until the new token is ready.
+     *
+     */
+    void setBackgroundTokenRefresh(bool enable)
+    {
+        gforms->setBackgroundTokenRefresh(enable);
+    }
+
     /**
      * Get the token type string.
      *
@@ -302,7 +365,12 @@ public:
     /** Reset stored config and auth credentials.
      *
      */
-    void reset() { gforms->authMan.reset(); };
+    void reset()
+    {
+        // the queued requests were made with the token of the credentials being reset
+        gforms->cancelAsyncRequests();
+        gforms->authMan.reset();
+    };
 
     /**
      * Get error reason from last operation.
@@ -548,6 +616,34 @@ public:
         return ret;
     }
 
+    /** List a form's responses and parse the response payload while it is being read.
+     *
+     * @param callback (GFORMS_JsonStreamCallback) The callback function that accepts the event type,
+     * the element path (e.g. responses/[0]/responseId) and the value as arguments.
+     * @param formId (string) The form ID.
+     * @param filter (string) Which form responses to return. Currently, the only supported filters are timestamp.
+     * @param pageSize (int) The maximum number of responses to return.
+     * @param pageToken (string) A page token returned by a previous list response.
+     * @return Boolean type status indicates the success of the operation.
+     *
+     * @note The response payload is not kept in memory which is suitable for the large response page.
+     *
+     * For ref doc, go to https://developers.google.com/forms/api/reference/rest/v1/forms.responses/list
+     *
+     */
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *>
+    bool listResponses(GFORMS_JsonStreamCallback callback, T1 formId, T2 filter = "", int pageSize = 0, T3 pageToken = "")
+    {
+        MB_String _response;
+
+        bool ret = gforms->listResponses(_response, toString(formId), "", toString(filter), pageSize, toString(pageToken), callback);
+
+        if (ret && _response.length() > 0)
+            ret = !gforms->isError(_response);
+
+        return ret;
+    }
+
     /** Get the list(array) of response ID in a form.
      *
      * @param formId (string) The form ID.
@@ -623,6 +719,46 @@ public:
         return ret;
     }
 
+    /** Get the responses of the response ID list from the form.
+     *
+     * @param responses (String array) The array of String that contains the returned responses in order of response ID.
+     * @param formId (string) The form ID.
+     * @param responseIds (String array) The array of response ID e.g. from getResponseIDList.
+     * @return Boolean type status indicates the success of all operations.
+     *
+     * @note The requests are sent back-to-back on the same keep-alive connection (up to GFORMS_PIPELINE_DEPTH
+     * requests ahead) before reading their responses in order, which saves the round trip time per response.
+     * The error response is kept in the array as the other responses.
+     *
+     * For ref doc, go to https://developers.google.com/forms/api/reference/rest/v1beta/forms.responses/get
+     *
+     */
+    template <typename T = const char *>
+    bool getResponses(std::vector<String> &responses, T formId, const std::vector<String> &responseIds)
+    {
+        return gforms->getResponses(toString(formId), responseIds, &responses);
+    }
+
+    /** Get the responses of the response ID list from the form and pass each response to the callback.
+     *
+     * @param formId (string) The form ID.
+     * @param responseIds (String array) The array of response ID e.g. from getResponseIDList.
+     * @param callback (GFORMS_ResponseItemCallback) The callback function that accepts the index, response ID, http code
+     * and the response payload of each response.
+     * @return Boolean type status indicates the success of all operations.
+     *
+     * @note The responses are not kept, the connection, receive and chunk buffers are reused for all responses,
+     * and the requests are pipelined as getResponses with the String array.
+     *
+     * For ref doc, go to https://developers.google.com/forms/api/reference/rest/v1beta/forms.responses/get
+     *
+     */
+    template <typename T = const char *>
+    bool getResponses(T formId, const std::vector<String> &responseIds, GFORMS_ResponseItemCallback callback)
+    {
+        return gforms->getResponses(toString(formId), responseIds, nullptr, callback);
+    }
+
     /** Create a new watch.
      *
      * @param response (FirebaseJson or String) The returned response.
@@ -854,6 +990,211 @@ public:
     }
 
 
+    /** Create a new form without waiting for the server response.
+     *
+     * @param request (GForms_AsyncRequest) The pointer to request data that keeps the state, http code and
+     * response payload until the request was finished.
+     * @param title (string) The title of the form which is visible to responders.
+     * @param docTitle (string) The title of the document which is visible in Drive.
+     * @param sharedUserEmail (string) Email of user to share the access.
+     * @param callback (optional) (GFORMS_AsyncCallback) The callback function that accepts the request data
+     * when the request was finished.
+     *
+     * @return Boolean type status indicates the request was queued.
+     *
+     * @note The request is sent and its response is read in loop, check for request->ready() or use the callback
+     * for the result. The request data should be kept until the request was finished.
+     *
+     */
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *>
+    bool createFormAsync(GForms_AsyncRequest *request, T1 title, T2 docTitle, T3 sharedUserEmail, GFORMS_AsyncCallback callback = NULL)
+    {
+        if (!gforms->beginAsync(request, callback))
+            return false;
+
+        request->shareEmail = toString(sharedUserEmail);
+
+        MB_String _response;
+        return gforms->endAsync(request, gforms->create(_response, toString(title), toString(docTitle)));
+    }
+
+    /** Change the form with a batch of updates without waiting for the server response.
+     *
+     * @param request (GForms_AsyncRequest) The pointer to request data.
+     * @param formId (string) The form ID.
+     * @param body (FirebaseJson of request object) The request body.
+     * @param callback (optional) (GFORMS_AsyncCallback) The callback function.
+     *
+     * @return Boolean type status indicates the request was queued.
+     *
+     */
+    template <typename T = const char *>
+    bool batchUpdateAsync(GForms_AsyncRequest *request, T formId, FirebaseJson *body, GFORMS_AsyncCallback callback = NULL)
+    {
+        if (!gforms->beginAsync(request, callback))
+            return false;
+
+        MB_String _response;
+        return gforms->endAsync(request, gforms->batchUpdate(_response, toString(formId), body));
+    }
+
+    /** Get a form without waiting for the server response.
+     *
+     * @param request (GForms_AsyncRequest) The pointer to request data.
+     * @param formId (string) The form ID.
+     * @param callback (optional) (GFORMS_AsyncCallback) The callback function.
+     *
+     * @return Boolean type status indicates the request was queued.
+     *
+     */
+    template <typename T = const char *>
+    bool getFormAsync(GForms_AsyncRequest *request, T formId, GFORMS_AsyncCallback callback = NULL)
+    {
+        if (!gforms->beginAsync(request, callback))
+            return false;
+
+        MB_String _response;
+        return gforms->endAsync(request, gforms->getForm(_response, toString(formId)));
+    }
+
+    /** List a form's responses without waiting for the server response.
+     *
+     * @param request (GForms_AsyncRequest) The pointer to request data.
+     * @param formId (string) The form ID.
+     * @param filter (string) Which form responses to return. Currently, the only supported filters are timestamp.
+     * @param pageSize (int) The maximum number of responses to return.
+     * @param pageToken (string) A page token returned by a previous list response.
+     * @param callback (optional) (GFORMS_AsyncCallback) The callback function.
+     *
+     * @return Boolean type status indicates the request was queued.
+     *
+     */
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *>
+    bool listResponsesAsync(GForms_AsyncRequest *request, T1 formId, T2 filter = "", int pageSize = 0, T3 pageToken = "", GFORMS_AsyncCallback callback = NULL)
+    {
+        if (!gforms->beginAsync(request, callback))
+            return false;
+
+        MB_String _response;
+        return gforms->endAsync(request, gforms->listResponses(_response, toString(formId), "", toString(filter), pageSize, toString(pageToken)));
+    }
+
+    /** Get one response from the form without waiting for the server response.
+     *
+     * @param request (GForms_AsyncRequest) The pointer to request data.
+     * @param formId (string) The form ID.
+     * @param responseId (string) The form's response ID.
+     * @param callback (optional) (GFORMS_AsyncCallback) The callback function.
+     *
+     * @return Boolean type status indicates the request was queued.
+     *
+     */
+    template <typename T1 = const char *, typename T2 = const char *>
+    bool getResponseAsync(GForms_AsyncRequest *request, T1 formId, T2 responseId, GFORMS_AsyncCallback callback = NULL)
+    {
+        if (!gforms->beginAsync(request, callback))
+            return false;
+
+        MB_String _response;
+        return gforms->endAsync(request, gforms->getResponse(_response, toString(formId), toString(responseId)));
+    }
+
+    /** Create a new watch without waiting for the server response.
+     *
+     * @param request (GForms_AsyncRequest) The pointer to request data.
+     * @param formId (string) The form ID.
+     * @param body (FirebaseJson of request object) The request body.
+     * @param callback (optional) (GFORMS_AsyncCallback) The callback function.
+     *
+     * @return Boolean type status indicates the request was queued.
+     *
+     */
+    template <typename T = const char *>
+    bool createWatchAsync(GForms_AsyncRequest *request, T formId, FirebaseJson *body, GFORMS_AsyncCallback callback = NULL)
+    {
+        if (!gforms->beginAsync(request, callback))
+            return false;
+
+        MB_String _response;
+        return gforms->endAsync(request, gforms->createWatch(_response, toString(formId), body));
+    }
+
+    /** Delete a watch without waiting for the server response.
+     *
+     * @param request (GForms_AsyncRequest) The pointer to request data.
+     * @param formId (string) The form ID.
+     * @param watchId (string) The watch ID.
+     * @param callback (optional) (GFORMS_AsyncCallback) The callback function.
+     *
+     * @return Boolean type status indicates the request was queued.
+     *
+     */
+    template <typename T1 = const char *, typename T2 = const char *>
+    bool deleteWatchAsync(GForms_AsyncRequest *request, T1 formId, T2 watchId, GFORMS_AsyncCallback callback = NULL)
+    {
+        if (!gforms->beginAsync(request, callback))
+            return false;
+
+        MB_String _response;
+        return gforms->endAsync(request, gforms->deleteWatch(_response, toString(formId), toString(watchId)));
+    }
+
+    /** Return a list of the watches owned by the invoking project without waiting for the server response.
+     *
+     * @param request (GForms_AsyncRequest) The pointer to request data.
+     * @param formId (string) The form ID.
+     * @param callback (optional) (GFORMS_AsyncCallback) The callback function.
+     *
+     * @return Boolean type status indicates the request was queued.
+     *
+     */
+    template <typename T = const char *>
+    bool listWatchesAsync(GForms_AsyncRequest *request, T formId, GFORMS_AsyncCallback callback = NULL)
+    {
+        if (!gforms->beginAsync(request, callback))
+            return false;
+
+        MB_String _response;
+        return gforms->endAsync(request, gforms->listWatches(_response, toString(formId)));
+    }
+
+    /** Renew an existing watch for seven days without waiting for the server response.
+     *
+     * @param request (GForms_AsyncRequest) The pointer to request data.
+     * @param formId (string) The form ID.
+     * @param watchId (string) The watch ID.
+     * @param callback (optional) (GFORMS_AsyncCallback) The callback function.
+     *
+     * @return Boolean type status indicates the request was queued.
+     *
+     */
+    template <typename T1 = const char *, typename T2 = const char *>
+    bool renewWatchAsync(GForms_AsyncRequest *request, T1 formId, T2 watchId, GFORMS_AsyncCallback callback = NULL)
+    {
+        if (!gforms->beginAsync(request, callback))
+            return false;
+
+        MB_String _response;
+        return gforms->endAsync(request, gforms->renewWatch(_response, toString(formId), toString(watchId)));
+    }
+
+    /** Process the queued async requests, this should be called in the loop.
+     *
+     * @note Each call runs one step (connect, send or read the available response data) of the current request
+     * and returns without waiting for the server response. The blocking functions finish the queued requests
+     * before they start. When the token should be renewed, the next request is held back until the token is ready.
+     *
+     */
+    void loop() { gforms->loop(); }
+
+    /** Cancel all queued async requests.
+     *
+     * @note The requests are set to error state with GFORMS_ERROR_ASYNC_REQUEST_CANCELLED http code
+     * and their callbacks are not called. This is also done by reset() and when the library was destroyed.
+     *
+     */
+    void cancelAsyncRequests() { gforms->cancelAsyncRequests(); }
+
 #if defined(MBFS_SD_FS) && defined(MBFS_CARD_TYPE_SD)
 
     /** Initiate SD card with SPI port configuration.
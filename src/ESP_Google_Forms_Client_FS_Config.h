@@ -63,6 +63,12 @@
 #define ESP_SIGNER_USE_PSRAM ESP_GOOGLE_FORMS_CLIENT_USE_PSRAM
 #endif
 
+// The BearSSL RSA engine used for token signing on ESP8266 and Raspberry Pi Pico.
+// 15, 31, 32 or 62 selects br_rsa_i15/i31/i32/i62_pkcs1_sign, leave undefined to use the
+// BearSSL default engine for the target word size (i62 with 64-bit multiply, i15 with slow multiply,
+// otherwise i31). The default engine is used when the selected engine is not available.
+// #define GFORMS_RSA_SIGN_ENGINE 31
+
 // To use external Client.
 // #define ESP_GOOGLE_FORMS_CLIENT_ENABLE_EXTERNAL_CLIENT
 
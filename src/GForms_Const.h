@@ -22,6 +22,39 @@
 #define GFORMS_DEFAULT_SERVER_RESPONSE_TIMEOUT 5 * 1000
 #define GFORMS_MAX_SERVER_RESPONSE_TIMEOUT 60 * 1000
 
+#define GFORMS_RESPONSE_RX_BUFFER_SIZE 1024
+#define GFORMS_RESPONSE_CHUNK_SIZE 2048
+
+// The maximum number of requests sent ahead of their responses on the keep-alive connection
+#ifndef GFORMS_PIPELINE_DEPTH
+#define GFORMS_PIPELINE_DEPTH 4
+#endif
+
+// The maximum number of response chunks that are read in one asynchronous request loop call
+#ifndef GFORMS_ASYNC_READS_PER_LOOP
+#define GFORMS_ASYNC_READS_PER_LOOP 2
+#endif
+
+// The idle time (ms) that the pooled connection is closed, it should be less than the keep-alive timeout (30 s)
+// of the server to not send the request on the connection that is being closed by server
+#ifndef GFORMS_KEEP_ALIVE_TIMEOUT
+#define GFORMS_KEEP_ALIVE_TIMEOUT 25 * 1000
+#endif
+
+// The maximum number of requests on the pooled connection before it is renewed
+#ifndef GFORMS_KEEP_ALIVE_MAX_REQUESTS
+#define GFORMS_KEEP_ALIVE_MAX_REQUESTS 100
+#endif
+
+// The maximum number of pooled connections that are opened at the same time
+#ifndef GFORMS_MAX_POOL_CONNECTIONS
+#if defined(ESP8266)
+#define GFORMS_MAX_POOL_CONNECTIONS 2
+#else
+#define GFORMS_MAX_POOL_CONNECTIONS 3
+#endif
+#endif
+
 #define GFORMS_MIN_WIFI_RECONNECT_TIMEOUT 10 * 1000
 #define GFORMS_MAX_WIFI_RECONNECT_TIMEOUT 5 * 60 * 1000
 
@@ -37,12 +70,25 @@
 #include "ESP_Google_Forms_Client_FS_Config.h"
 #include "mbfs/MB_FS.h"
 #include "auth/MB_NTP.h"
+#include "GForms_KeyScan.h"
 #if defined(ESP32)
 #include "mbedtls/pk.h"
 #include "mbedtls/entropy.h"
 #include "mbedtls/ctr_drbg.h"
 #endif
 
+// The background token refresher runs as FreeRTOS task with its own SSL client
+#if defined(ESP32) && !defined(ESP_GOOGLE_FORMS_CLIENT_ENABLE_EXTERNAL_CLIENT)
+#define GFORMS_BACKGROUND_TOKEN_REFRESH
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#ifndef GFORMS_TOKEN_REFRESH_TASK_STACK_SIZE
+#define GFORMS_TOKEN_REFRESH_TASK_STACK_SIZE 12 * 1024
+#endif
+#define GFORMS_TOKEN_REFRESH_RETRY_INTERVAL 10 * 1000
+#endif
+
 #if defined(ESP8266)
 
 //__GNUC__
@@ -265,10 +311,14 @@ struct gauth_token_signer_resources_t
     char *hash = nullptr;
 #endif
     unsigned char *signature = nullptr;
-    MB_String encHeader;
-    MB_String encPayload;
-    MB_String encHeadPayload;
+    /* the encoded JWT header and constant claims ("<header>.<claims>") of the service account (jwtIdentity) */
+    MB_String jwtPrefix;
+    /* the last 0 - 2 bytes of constant claims which were not encoded in jwtPrefix */
+    MB_String jwtPrefixTail;
+    MB_String jwtIdentity;
     MB_String encSignature;
+    /* keep the parsed private key in memory instead of parsing the PEM key on every token signing */
+    bool keepParsedKey = false;
 #if defined(ESP32)
     mbedtls_pk_context *pk_ctx = nullptr;
     mbedtls_entropy_context *entropy_ctx = nullptr;
@@ -330,13 +380,22 @@ struct gforms_tcp_response_handler_t
     Client *client = nullptr;
     // the chunk state info
     gforms_chunk_state_info chunkState;
+    // the receive buffer for bulk reading from client
+    char *rxBuf = nullptr;
+    // the size of receive buffer
+    int rxBufLen = 0;
+    // the read position and the end of data in receive buffer
+    int rxPos = 0;
+    int rxEnd = 0;
+    // keep the unread data in client and receive buffer for the next pipelined response
+    bool keepData = false;
 
 public:
     int available()
     {
         if (client)
-            return client->available();
-        return false;
+            return client->available() + rxEnd - rxPos;
+        return rxEnd - rxPos;
     }
 };
 
@@ -389,6 +448,12 @@ struct gauth_auth_cert_t
     mb_fs_mem_storage_type file_storage = mb_fs_mem_storage_type_flash;
 };
 
+struct gauth_token_cache_t
+{
+    MB_String file;
+    mb_fs_mem_storage_type storage_type = mb_fs_mem_storage_type_flash;
+};
+
 struct gauth_cfg_int_t
 {
     bool processing = false;
@@ -411,6 +476,13 @@ struct gauth_cfg_int_t
     bool auth_uri = false;
 
     MB_String auth_token;
+    /* changed whenever auth_token was assigned or cleared */
+    uint32_t auth_token_generation = 0;
+    /* the access token and expiry timestamp read from token cache file */
+    MB_String cached_token;
+    unsigned long cached_expires = 0;
+    /* the identity CRC of the service account that the cached token was issued for */
+    uint16_t cached_crc = 0;
     MB_String refresh_token;
     MB_String client_id;
     MB_String client_secret;
@@ -461,6 +533,7 @@ struct gauth_cfg_t
     struct gauth_service_account_t service_account;
     float time_zone = 0;
     struct gauth_auth_cert_t cert;
+    struct gauth_token_cache_t token_cache;
     struct gauth_token_signer_resources_t signer;
     struct gauth_cfg_int_t internal;
     TokenStatusCallback token_status_callback = NULL;
@@ -485,7 +558,153 @@ typedef void (*GFORMS_NetworkConnectionRequestCallback)(void);
 typedef void (*GFORMS_NetworkStatusRequestCallback)(void);
 typedef void (*GFORMS_ResponseCallback)(const char *);
 
-static const unsigned char gforms_base64_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+typedef enum
+{
+    gforms_json_stream_event_object_begin,
+    gforms_json_stream_event_object_end,
+    gforms_json_stream_event_array_begin,
+    gforms_json_stream_event_array_end,
+    gforms_json_stream_event_string,
+    gforms_json_stream_event_number,
+    gforms_json_stream_event_boolean,
+    gforms_json_stream_event_null
+} gforms_json_stream_event_type;
+
+typedef enum
+{
+    gforms_json_stream_step_value,
+    gforms_json_stream_step_key,
+    gforms_json_stream_step_colon,
+    gforms_json_stream_step_next,
+    gforms_json_stream_step_string,
+    gforms_json_stream_step_literal
+} gforms_json_stream_step;
+
+/* path is the FirebaseJson style path of the element e.g. responses/[0]/responseId */
+typedef void (*GFORMS_JsonStreamCallback)(gforms_json_stream_event_type type, const char *path, const char *value);
+
+/* index is the position of responseId in the requested list, payload is valid only during the callback */
+typedef void (*GFORMS_ResponseItemCallback)(size_t index, const char *responseId, int httpCode, const char *payload);
+
+struct gforms_json_stream_state_t
+{
+    GFORMS_JsonStreamCallback callback = NULL;
+    gforms_json_stream_step step = gforms_json_stream_step_value;
+    // the path of current element
+    MB_String path;
+    // the last object key read
+    MB_String key;
+    // the string or literal that is being read, can be spanned over chunks
+    MB_String token;
+    // the container ('{' or '[') of each nesting level
+    MB_VECTOR<char> containers;
+    // the array index of each nesting level
+    MB_VECTOR<int> indexes;
+    // the parent path length of each nested value
+    MB_VECTOR<size_t> pathLens;
+    bool tokenIsKey = false;
+    bool escape = false;
+    // remaining hex digits of \uXXXX escape
+    uint8_t hexCount = 0;
+    uint32_t hex = 0;
+    uint32_t highSurrogate = 0;
+    bool error = false;
+};
+
+// The hosts that keep their own connection in the connection pool
+typedef enum
+{
+    gforms_pool_host_forms,
+    gforms_pool_host_drive,
+    gforms_pool_host_token,
+    gforms_pool_host_max
+} gforms_pool_host;
+
+// The state of the response that is being read, which can be resumed when more data is available
+struct gforms_response_reader_t
+{
+    struct gforms_tcp_response_handler_t tcpHandler;
+    struct gforms_server_response_data_t response;
+    struct gforms_key_scan_state_t keyScan;
+    char *chunk = nullptr;
+    const char *key = "";
+    size_t keyLen = 0;
+    gforms_json_stream_state_t *stream = nullptr;
+    // the response data was arrived (or the connection was closed)
+    bool started = false;
+    bool complete = false;
+};
+
+typedef enum
+{
+    gforms_async_state_idle,
+    gforms_async_state_connect,
+    gforms_async_state_send,
+    gforms_async_state_response,
+    gforms_async_state_complete,
+    gforms_async_state_error
+} gforms_async_state;
+
+struct gforms_async_request_t;
+
+typedef void (*GFORMS_AsyncCallback)(struct gforms_async_request_t *request);
+
+struct gforms_async_request_t
+{
+    gforms_async_state state = gforms_async_state_idle;
+    // the http status code, or the error code (negative value)
+    int httpCode = 0;
+    // the operation was completed without error
+    bool success = false;
+    // the response payload
+    MB_String payload;
+    GFORMS_AsyncCallback callback = NULL;
+    // the request header and body to send
+    MB_String req;
+    int hostType = 0;
+    // the auth_token_generation of the token in req
+    uint32_t tokenGeneration = 0;
+    // the key to collect the values
+    MB_String key;
+    struct gforms_response_reader_t reader;
+    // the user to share the created form with and the response of form creation
+    MB_String shareEmail;
+    MB_String createResponse;
+
+    // the operation was finished (successfully or not)
+    bool ready()
+    {
+        return state == gforms_async_state_complete || state == gforms_async_state_error;
+    }
+
+    const char *response()
+    {
+        return payload.c_str();
+    }
+};
+
+typedef struct gforms_async_request_t GForms_AsyncRequest;
+
+static const unsigned char gforms_base64_table[65] PROGMEM = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const unsigned char gforms_base64_url_table[65] PROGMEM = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+// The 6 bit values of the standard alphabet characters, 0x80 for the other characters and 0 for '='
+static const unsigned char gforms_base64_dec_table[256] PROGMEM = {
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x3e, 0x80, 0x80, 0x80, 0x3f,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x80, 0x80, 0x80, 0x00, 0x80, 0x80,
+    0x80, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80};
 
 static const char gauth_pgm_str_1[] PROGMEM = "type";
 static const char gauth_pgm_str_2[] PROGMEM = "service_account";
@@ -531,6 +750,8 @@ static const char gauth_pgm_str_42[] PROGMEM = "error";
 static const char gauth_pgm_str_43[] PROGMEM = "error_description";
 static const char gauth_pgm_str_44[] PROGMEM = "access_token";
 static const char gauth_pgm_str_45[] PROGMEM = "Bearer ";
+static const char gauth_pgm_str_46[] PROGMEM = "expires";
+static const char gauth_pgm_str_47[] PROGMEM = "crc";
 
 static const char gforms_pgm_str_1[] PROGMEM = "\r\n";
 static const char gforms_pgm_str_2[] PROGMEM = ".";
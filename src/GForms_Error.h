@@ -79,4 +79,5 @@
 #define GFORMS_ERROR_UDP_CLIENT_REQUIRED /*          */ (GFORMS_ERROR_RANGE - 17)
 #define GFORMS_ERROR_MISSING_SERVICE_ACCOUNT_CREDENTIALS /*          */ (GFORMS_ERROR_RANGE - 18)
 #define GFORMS_ERROR_SERVICE_ACCOUNT_JSON_FILE_PARSING_ERROR /*          */ (GFORMS_ERROR_RANGE - 19)
+#define GFORMS_ERROR_ASYNC_REQUEST_CANCELLED /*          */ (GFORMS_ERROR_RANGE - 20)
 #endif
\ No newline at end of file
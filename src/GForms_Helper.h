@@ -703,6 +703,341 @@ namespace JsonHelper
 
 };
 
+namespace JsonStreamHelper
+{
+
+    inline void begin(gforms_json_stream_state_t &state, GFORMS_JsonStreamCallback callback)
+    {
+        state.callback = callback;
+        state.step = gforms_json_stream_step_value;
+        state.path.clear();
+        state.key.clear();
+        state.token.clear();
+        state.containers.clear();
+        state.indexes.clear();
+        state.pathLens.clear();
+        state.tokenIsKey = false;
+        state.escape = false;
+        state.hexCount = 0;
+        state.hex = 0;
+        state.highSurrogate = 0;
+        state.error = false;
+    }
+
+    inline void emit(gforms_json_stream_state_t &state, gforms_json_stream_event_type type, const char *value)
+    {
+        if (state.callback)
+            state.callback(type, state.path.c_str(), value);
+    }
+
+    // Append the path segment of the value that is about to begin
+    inline void beginValue(gforms_json_stream_state_t &state)
+    {
+        size_t len = state.path.length();
+        state.pathLens.push_back(len);
+
+        size_t level = state.containers.size();
+        if (level == 0)
+            return;
+
+        if (len > 0)
+            state.path += '/';
+
+        if (state.containers[level - 1] == '[')
+        {
+            state.path += '[';
+            state.path += state.indexes[level - 1];
+            state.path += ']';
+        }
+        else
+            state.path += state.key;
+    }
+
+    // Restore the parent path after the value was completely read
+    inline void endValue(gforms_json_stream_state_t &state)
+    {
+        size_t n = state.pathLens.size();
+        if (n > 0)
+        {
+            state.path.erase(state.pathLens[n - 1]);
+            state.pathLens.pop_back();
+        }
+
+        size_t level = state.containers.size();
+        if (level > 0 && state.containers[level - 1] == '[')
+            state.indexes[level - 1]++;
+
+        state.step = level > 0 ? gforms_json_stream_step_next : gforms_json_stream_step_value;
+    }
+
+    inline void beginContainer(gforms_json_stream_state_t &state, char c)
+    {
+        beginValue(state);
+        int index = 0;
+        state.containers.push_back(c);
+        state.indexes.push_back(index);
+        emit(state, c == '{' ? gforms_json_stream_event_object_begin : gforms_json_stream_event_array_begin, "");
+        state.step = c == '{' ? gforms_json_stream_step_key : gforms_json_stream_step_value;
+    }
+
+    inline bool endContainer(gforms_json_stream_state_t &state, char c)
+    {
+        size_t level = state.containers.size();
+        if (level == 0 || state.containers[level - 1] != (c == '}' ? '{' : '['))
+            return false;
+
+        state.containers.pop_back();
+        state.indexes.pop_back();
+        emit(state, c == '}' ? gforms_json_stream_event_object_end : gforms_json_stream_event_array_end, "");
+        endValue(state);
+        return true;
+    }
+
+    inline bool endLiteral(gforms_json_stream_state_t &state)
+    {
+        const char *t = state.token.c_str();
+        gforms_json_stream_event_type type = gforms_json_stream_event_number;
+
+        if (strcmp(t, "true") == 0 || strcmp(t, "false") == 0)
+            type = gforms_json_stream_event_boolean;
+        else if (strcmp(t, "null") == 0)
+            type = gforms_json_stream_event_null;
+        else if (t[0] != '-' && (t[0] < '0' || t[0] > '9'))
+            return false;
+
+        emit(state, type, t);
+        state.token.clear();
+        endValue(state);
+        return true;
+    }
+
+    inline void appendUTF8(MB_String &out, uint32_t cp)
+    {
+        if (cp == 0)
+            return;
+
+        if (cp < 0x80)
+            out += (char)cp;
+        else if (cp < 0x800)
+        {
+            out += (char)(0xC0 | (cp >> 6));
+            out += (char)(0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000)
+        {
+            out += (char)(0xE0 | (cp >> 12));
+            out += (char)(0x80 | ((cp >> 6) & 0x3F));
+            out += (char)(0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            out += (char)(0xF0 | (cp >> 18));
+            out += (char)(0x80 | ((cp >> 12) & 0x3F));
+            out += (char)(0x80 | ((cp >> 6) & 0x3F));
+            out += (char)(0x80 | (cp & 0x3F));
+        }
+    }
+
+    // Process the escape sequence or the end of string
+    inline bool readString(gforms_json_stream_state_t &state, char c)
+    {
+        if (state.hexCount > 0)
+        {
+            uint8_t v = 0;
+            if (c >= '0' && c <= '9')
+                v = c - '0';
+            else if (c >= 'a' && c <= 'f')
+                v = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                v = c - 'A' + 10;
+            else
+                return false;
+
+            state.hex = (state.hex << 4) | v;
+
+            if (--state.hexCount == 0)
+            {
+                // UTF-16 surrogate pair
+                if (state.hex >= 0xD800 && state.hex <= 0xDBFF)
+                    state.highSurrogate = state.hex;
+                else
+                {
+                    if (state.highSurrogate > 0 && state.hex >= 0xDC00 && state.hex <= 0xDFFF)
+                        appendUTF8(state.token, 0x10000 + (((state.highSurrogate & 0x3FF) << 10) | (state.hex & 0x3FF)));
+                    else
+                        appendUTF8(state.token, state.hex);
+                    state.highSurrogate = 0;
+                }
+            }
+        }
+        else if (state.escape)
+        {
+            state.escape = false;
+            switch (c)
+            {
+            case 'b':
+                state.token += '\b';
+                break;
+            case 'f':
+                state.token += '\f';
+                break;
+            case 'n':
+                state.token += '\n';
+                break;
+            case 'r':
+                state.token += '\r';
+                break;
+            case 't':
+                state.token += '\t';
+                break;
+            case 'u':
+                state.hexCount = 4;
+                state.hex = 0;
+                break;
+            default:
+                state.token += c;
+                break;
+            }
+        }
+        else if (c == '\\')
+            state.escape = true;
+        else if (c == '"')
+        {
+            if (state.tokenIsKey)
+            {
+                state.key = state.token;
+                state.step = gforms_json_stream_step_colon;
+            }
+            else
+            {
+                emit(state, gforms_json_stream_event_string, state.token.c_str());
+                endValue(state);
+            }
+            state.token.clear();
+        }
+        else
+            state.token += c;
+
+        return true;
+    }
+
+    // Parse the chunk of JSON text and emit the events, the state is kept for the next chunk.
+    // Returns false if syntax error was found.
+    inline bool parse(gforms_json_stream_state_t &state, const char *buf, size_t len)
+    {
+        size_t i = 0;
+
+        while (i < len && !state.error)
+        {
+            char c = buf[i];
+
+            if (state.step == gforms_json_stream_step_string)
+            {
+                // copy the unescaped characters at once
+                if (state.hexCount == 0 && !state.escape && c != '"' && c != '\\')
+                {
+                    size_t n = 1;
+                    while (i + n < len && buf[i + n] != '"' && buf[i + n] != '\\')
+                        n++;
+                    state.token.append(buf + i, n);
+                    i += n;
+                }
+                else
+                {
+                    state.error = !readString(state, c);
+                    i++;
+                }
+                continue;
+            }
+
+            if (state.step == gforms_json_stream_step_literal)
+            {
+                if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.' || c == 'E')
+                {
+                    state.token += c;
+                    i++;
+                }
+                // the delimiter is not consumed here
+                else
+                    state.error = !endLiteral(state);
+                continue;
+            }
+
+            i++;
+
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+                continue;
+
+            switch (state.step)
+            {
+            case gforms_json_stream_step_value:
+                if (c == '{' || c == '[')
+                    beginContainer(state, c);
+                else if (c == ']')
+                    state.error = !endContainer(state, c);
+                else if (c == '"')
+                {
+                    beginValue(state);
+                    state.tokenIsKey = false;
+                    state.step = gforms_json_stream_step_string;
+                }
+                else if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n')
+                {
+                    beginValue(state);
+                    state.token += c;
+                    state.step = gforms_json_stream_step_literal;
+                }
+                else
+                    state.error = true;
+                break;
+
+            case gforms_json_stream_step_key:
+                if (c == '"')
+                {
+                    state.tokenIsKey = true;
+                    state.step = gforms_json_stream_step_string;
+                }
+                else if (c == '}')
+                    state.error = !endContainer(state, c);
+                else
+                    state.error = true;
+                break;
+
+            case gforms_json_stream_step_colon:
+                if (c == ':')
+                    state.step = gforms_json_stream_step_value;
+                else
+                    state.error = true;
+                break;
+
+            case gforms_json_stream_step_next:
+                if (c == ',')
+                    state.step = state.containers[state.containers.size() - 1] == '{' ? gforms_json_stream_step_key : gforms_json_stream_step_value;
+                else if (c == '}' || c == ']')
+                    state.error = !endContainer(state, c);
+                else
+                    state.error = true;
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        return !state.error;
+    }
+
+    // Flush the pending top level literal, returns false if the data was incomplete or invalid
+    inline bool end(gforms_json_stream_state_t &state)
+    {
+        if (state.step == gforms_json_stream_step_literal && !state.error)
+            state.error = !endLiteral(state);
+
+        return !state.error && state.containers.size() == 0;
+    }
+
+};
+
 namespace Base64Helper
 {
 
@@ -736,26 +1071,37 @@ namespace Base64Helper
         return (3 * (len / 4)) - pad;
     }
 
-    inline unsigned char *creatBase64EncBuffer(MB_FS *mbfs, bool isURL)
+    // Encode the complete 3 byte groups of in to out (4 characters for each group), returns the number of bytes encoded
+    inline size_t encodeGroups(const unsigned char *table, const uint8_t *in, size_t len, unsigned char *out)
     {
-        unsigned char *base64EncBuf = MemoryHelper::createBuffer<unsigned char *>(mbfs, 65);
-        strcpy_P((char *)base64EncBuf, (char *)gforms_base64_table);
-        if (isURL)
+        size_t i = 0;
+#if UINTPTR_MAX > 0xFFFFFFFFUL
+        // two groups from a 48 bit word
+        for (; i + 6 <= len; i += 6)
         {
-            base64EncBuf[62] = '-';
-            base64EncBuf[63] = '_';
+            uint64_t w = ((uint64_t)in[i] << 40) | ((uint64_t)in[i + 1] << 32) | ((uint64_t)in[i + 2] << 24) |
+                         ((uint64_t)in[i + 3] << 16) | ((uint64_t)in[i + 4] << 8) | (uint64_t)in[i + 5];
+            out[0] = pgm_read_byte(table + ((w >> 42) & 0x3F));
+            out[1] = pgm_read_byte(table + ((w >> 36) & 0x3F));
+            out[2] = pgm_read_byte(table + ((w >> 30) & 0x3F));
+            out[3] = pgm_read_byte(table + ((w >> 24) & 0x3F));
+            out[4] = pgm_read_byte(table + ((w >> 18) & 0x3F));
+            out[5] = pgm_read_byte(table + ((w >> 12) & 0x3F));
+            out[6] = pgm_read_byte(table + ((w >> 6) & 0x3F));
+            out[7] = pgm_read_byte(table + (w & 0x3F));
+            out += 8;
         }
-        return base64EncBuf;
-    }
-
-    inline unsigned char *creatBase64DecBuffer(MB_FS *mbfs)
-    {
-        unsigned char *base64DecBuf = MemoryHelper::createBuffer<unsigned char *>(mbfs, 256, false);
-        memset(base64DecBuf, 0x80, 256);
-        for (size_t i = 0; i < sizeof(gforms_base64_table) - 1; i++)
-            base64DecBuf[gforms_base64_table[i]] = (unsigned char)i;
-        base64DecBuf['='] = 0;
-        return base64DecBuf;
+#endif
+        for (; i + 3 <= len; i += 3)
+        {
+            uint32_t w = ((uint32_t)in[i] << 16) | ((uint32_t)in[i + 1] << 8) | (uint32_t)in[i + 2];
+            out[0] = pgm_read_byte(table + ((w >> 18) & 0x3F));
+            out[1] = pgm_read_byte(table + ((w >> 12) & 0x3F));
+            out[2] = pgm_read_byte(table + ((w >> 6) & 0x3F));
+            out[3] = pgm_read_byte(table + (w & 0x3F));
+            out += 4;
+        }
+        return i;
     }
 
     template <typename T = uint8_t>
@@ -793,11 +1139,10 @@ namespace Base64Helper
     }
 
     template <typename T>
-    inline bool decode(MB_FS *mbfs, unsigned char *base64DecBuf, const char *src, size_t len, gforms_base64_io_t<T> &out)
+    inline bool decode(MB_FS *mbfs, const unsigned char *table, const char *src, size_t len, gforms_base64_io_t<T> &out)
     {
         // the maximum chunk size that writes to output is limited by out.bufLen, the minimum is depending on the source length
-        bool ret = false;
-        unsigned char *block = MemoryHelper::createBuffer<unsigned char *>(mbfs, 4, false);
+        unsigned char block[4];
         unsigned char temp;
         size_t i, count;
         int pad = 0;
@@ -810,12 +1155,12 @@ namespace Base64Helper
 
         for (i = 0; i < len; i++)
         {
-            if ((uint8_t)base64DecBuf[(uint8_t)src[i]] != 0x80)
+            if (pgm_read_byte(table + (uint8_t)src[i]) != 0x80)
                 count++;
         }
 
         if (count == 0)
-            goto skip;
+            return false;
 
         extra_pad = (4 - count % 4) % 4;
         count = 0;
@@ -823,12 +1168,38 @@ namespace Base64Helper
         {
             unsigned char val;
 
+            // decode the complete groups without padding at once
+            while (count == 0 && i + 4 <= len)
+            {
+                uint32_t w = 0;
+                uint8_t k = 0;
+                for (; k < 4; k++)
+                {
+                    val = src[i + k];
+                    temp = pgm_read_byte(table + val);
+                    if (temp == 0x80 || val == '=')
+                        break;
+                    w = (w << 6) | temp;
+                }
+
+                if (k < 4)
+                    break;
+
+                setOutput(mbfs, (uint8_t)(w >> 16), out, &pos);
+                setOutput(mbfs, (uint8_t)(w >> 8), out, &pos);
+                setOutput(mbfs, (uint8_t)w, out, &pos);
+                i += 4;
+            }
+
+            if (i >= len + extra_pad)
+                break;
+
             if (i >= len)
                 val = '=';
             else
                 val = src[i];
 
-            temp = base64DecBuf[val];
+            temp = pgm_read_byte(table + val);
 
             if (temp == 0x80)
                 continue;
@@ -849,7 +1220,7 @@ namespace Base64Helper
                     if (pad == 1)
                         setOutput(mbfs, (block[1] << 4) | (block[2] >> 2), out, &pos);
                     else if (pad > 2)
-                        goto skip;
+                        return false;
 
                     break;
                 }
@@ -863,37 +1234,33 @@ namespace Base64Helper
 
         // write remaining
         if (out.bufWrite > 0 && !writeOutput(mbfs, out))
-            goto skip;
-
-        ret = true;
+            return false;
 
-    skip:
-        MemoryHelper::freeBuffer(mbfs, block);
-        return ret;
+        return true;
     }
 
     template <typename T>
-    inline bool encodeLast(MB_FS *mbfs, unsigned char *base64EncBuf, const unsigned char *in, size_t len,
+    inline bool encodeLast(MB_FS *mbfs, const unsigned char *table, const unsigned char *in, size_t len,
                            gforms_base64_io_t<T> &out, T **pos)
     {
         if (len > 2)
             return false;
 
-        if (!setOutput(mbfs, base64EncBuf[in[0] >> 2], out, pos))
+        if (!setOutput(mbfs, pgm_read_byte(table + (in[0] >> 2)), out, pos))
             return false;
 
         if (len == 1)
         {
-            if (!setOutput(mbfs, base64EncBuf[(in[0] & 0x03) << 4], out, pos))
+            if (!setOutput(mbfs, pgm_read_byte(table + ((in[0] & 0x03) << 4)), out, pos))
                 return false;
             if (!setOutput(mbfs, '=', out, pos))
                 return false;
         }
         else
         {
-            if (!setOutput(mbfs, base64EncBuf[((in[0] & 0x03) << 4) | (in[1] >> 4)], out, pos))
+            if (!setOutput(mbfs, pgm_read_byte(table + (((in[0] & 0x03) << 4) | (in[1] >> 4))), out, pos))
                 return false;
-            if (!setOutput(mbfs, base64EncBuf[(in[1] & 0x0f) << 2], out, pos))
+            if (!setOutput(mbfs, pgm_read_byte(table + ((in[1] & 0x0f) << 2)), out, pos))
                 return false;
         }
 
@@ -904,7 +1271,7 @@ namespace Base64Helper
     }
 
     template <typename T>
-    inline bool encode(MB_FS *mbfs, unsigned char *base64EncBuf, uint8_t *src, size_t len,
+    inline bool encode(MB_FS *mbfs, const unsigned char *table, uint8_t *src, size_t len,
                        gforms_base64_io_t<T> &out, bool writeAllRemaining = true)
     {
         const unsigned char *end, *in;
@@ -913,20 +1280,54 @@ namespace Base64Helper
         in = src;
         end = src + len;
 
+        if (out.outT && sizeof(T) == 1)
+        {
+            bool buffered = out.outC || out.filetype != mb_fs_mem_storage_type_undefined;
+
+            // encode the groups directly into the output memory or the output buffer
+            while (end - in >= 3)
+            {
+                size_t n = end - in;
+
+                if (buffered)
+                {
+                    size_t room = (out.bufLen - out.bufWrite) / 4 * 3;
+                    if (room == 0)
+                    {
+                        if (!writeOutput(mbfs, out))
+                            return false;
+                        continue;
+                    }
+
+                    n = encodeGroups(table, in, n < room ? n : room, (unsigned char *)&out.outT[out.bufWrite]);
+                    out.bufWrite += n / 3 * 4;
+                    if (out.bufWrite == (int)out.bufLen && !writeOutput(mbfs, out))
+                        return false;
+                }
+                else
+                {
+                    n = encodeGroups(table, in, n, (unsigned char *)pos);
+                    pos += n / 3 * 4;
+                }
+
+                in += n;
+            }
+        }
+
         while (end - in >= 3)
         {
-            if (!setOutput(mbfs, base64EncBuf[in[0] >> 2], out, &pos))
+            if (!setOutput(mbfs, pgm_read_byte(table + (in[0] >> 2)), out, &pos))
                 return false;
-            if (!setOutput(mbfs, base64EncBuf[((in[0] & 0x03) << 4) | (in[1] >> 4)], out, &pos))
+            if (!setOutput(mbfs, pgm_read_byte(table + (((in[0] & 0x03) << 4) | (in[1] >> 4))), out, &pos))
                 return false;
-            if (!setOutput(mbfs, base64EncBuf[((in[1] & 0x0f) << 2) | (in[2] >> 6)], out, &pos))
+            if (!setOutput(mbfs, pgm_read_byte(table + (((in[1] & 0x0f) << 2) | (in[2] >> 6))), out, &pos))
                 return false;
-            if (!setOutput(mbfs, base64EncBuf[in[2] & 0x3f], out, &pos))
+            if (!setOutput(mbfs, pgm_read_byte(table + (in[2] & 0x3f)), out, &pos))
                 return false;
             in += 3;
         }
 
-        if (end - in && !encodeLast(mbfs, base64EncBuf, in, end - in, out, &pos))
+        if (end - in && !encodeLast(mbfs, table, in, end - in, out, &pos))
             return false;
 
         if (writeAllRemaining && out.bufWrite > 0 && !writeOutput(mbfs, out))
@@ -939,10 +1340,7 @@ namespace Base64Helper
     {
         gforms_base64_io_t<T> out;
         out.outL = &val;
-        unsigned char *base64DecBuf = creatBase64DecBuffer(mbfs);
-        bool ret = decode<T>(mbfs, base64DecBuf, src.c_str(), src.length(), out);
-        MemoryHelper::freeBuffer(mbfs, base64DecBuf);
-        return ret;
+        return decode<T>(mbfs, gforms_base64_dec_table, src.c_str(), src.length(), out);
     }
 
     inline bool decodeToFile(MB_FS *mbfs, const char *src, size_t len, mbfs_file_type type)
@@ -951,42 +1349,30 @@ namespace Base64Helper
         out.filetype = type;
         uint8_t *buf = MemoryHelper::createBuffer<uint8_t *>(mbfs, out.bufLen);
         out.outT = buf;
-        unsigned char *base64DecBuf = creatBase64DecBuffer(mbfs);
-        bool ret = decode<uint8_t>(mbfs, base64DecBuf, src, strlen(src), out);
+        bool ret = decode<uint8_t>(mbfs, gforms_base64_dec_table, src, strlen(src), out);
         MemoryHelper::freeBuffer(mbfs, buf);
-        MemoryHelper::freeBuffer(mbfs, base64DecBuf);
         return ret;
     }
 
     inline void encodeUrl(MB_FS *mbfs, char *encoded, unsigned char *string, size_t len)
     {
-        size_t i;
-        char *p = encoded;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mbfs, true);
-
-        for (i = 0; i < len - 2; i += 3)
-        {
-            *p++ = base64EncBuf[(string[i] >> 2) & 0x3F];
-            *p++ = base64EncBuf[((string[i] & 0x3) << 4) | ((int)(string[i + 1] & 0xF0) >> 4)];
-            *p++ = base64EncBuf[((string[i + 1] & 0xF) << 2) | ((int)(string[i + 2] & 0xC0) >> 6)];
-            *p++ = base64EncBuf[string[i + 2] & 0x3F];
-        }
+        size_t i = encodeGroups(gforms_base64_url_table, string, len, (unsigned char *)encoded);
+        char *p = encoded + i / 3 * 4;
 
+        // the last 1 or 2 bytes without padding
         if (i < len)
         {
-            *p++ = base64EncBuf[(string[i] >> 2) & 0x3F];
+            *p++ = pgm_read_byte(gforms_base64_url_table + (string[i] >> 2));
             if (i == (len - 1))
-                *p++ = base64EncBuf[((string[i] & 0x3) << 4)];
+                *p++ = pgm_read_byte(gforms_base64_url_table + ((string[i] & 0x3) << 4));
             else
             {
-                *p++ = base64EncBuf[((string[i] & 0x3) << 4) | ((int)(string[i + 1] & 0xF0) >> 4)];
-                *p++ = base64EncBuf[((string[i + 1] & 0xF) << 2)];
+                *p++ = pgm_read_byte(gforms_base64_url_table + (((string[i] & 0x3) << 4) | (string[i + 1] >> 4)));
+                *p++ = pgm_read_byte(gforms_base64_url_table + ((string[i + 1] & 0xF) << 2));
             }
         }
 
         *p++ = '\0';
-
-        MemoryHelper::freeBuffer(mbfs, base64EncBuf);
     }
 
     inline MB_String encodeToString(MB_FS *mbfs, uint8_t *src, size_t len)
@@ -995,11 +1381,9 @@ namespace Base64Helper
         char *encoded = MemoryHelper::createBuffer<char *>(mbfs, encodedLength(len) + 1);
         gforms_base64_io_t<char> out;
         out.outT = encoded;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mbfs, false);
-        if (encode<char>(mbfs, base64EncBuf, (uint8_t *)src, len, out))
+        if (encode<char>(mbfs, gforms_base64_table, (uint8_t *)src, len, out))
             str = encoded;
         MemoryHelper::freeBuffer(mbfs, encoded);
-        MemoryHelper::freeBuffer(mbfs, base64EncBuf);
         return str;
     }
 
@@ -1009,10 +1393,8 @@ namespace Base64Helper
         out.outC = client;
         uint8_t *buf = MemoryHelper::createBuffer<uint8_t *>(mbfs, out.bufLen);
         out.outT = buf;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mbfs, false);
-        bool ret = encode<uint8_t>(mbfs, base64EncBuf, (uint8_t *)data, len, out);
+        bool ret = encode<uint8_t>(mbfs, gforms_base64_table, (uint8_t *)data, len, out);
         MemoryHelper::freeBuffer(mbfs, buf);
-        MemoryHelper::freeBuffer(mbfs, base64EncBuf);
         return ret;
     }
 };
@@ -1211,6 +1593,8 @@ namespace HttpHelper
         tcpHandler.header.clear();
         tcpHandler.dataTime = millis();
         tcpHandler.payload = payload;
+        tcpHandler.rxPos = 0;
+        tcpHandler.rxEnd = 0;
     }
 
     inline int readLine(Client *client, char *buf, int bufLen)
@@ -1272,6 +1656,87 @@ namespace HttpHelper
         return idx;
     }
 
+    // Refill the receive buffer with the available data in one read when it is empty,
+    // returns the number of bytes in receive buffer
+    inline int fillRxBuffer(struct gforms_tcp_response_handler_t &tcpHandler)
+    {
+        if (tcpHandler.rxPos < tcpHandler.rxEnd)
+            return tcpHandler.rxEnd - tcpHandler.rxPos;
+
+        tcpHandler.rxPos = 0;
+        tcpHandler.rxEnd = 0;
+
+        if (!tcpHandler.client)
+            return 0;
+
+        int len = tcpHandler.client->available();
+        if (len <= 0)
+            return 0;
+
+        if (len > tcpHandler.rxBufLen)
+            len = tcpHandler.rxBufLen;
+
+        Utils::idle();
+
+        int readLen = tcpHandler.client->read((uint8_t *)tcpHandler.rxBuf, len);
+        if (readLen > 0)
+            tcpHandler.rxEnd = readLen;
+
+        return tcpHandler.rxEnd;
+    }
+
+    // Read line from the receive buffer, falls back to byte reading if no receive buffer
+    inline int readLine(struct gforms_tcp_response_handler_t &tcpHandler, char *buf, int bufLen)
+    {
+        if (!tcpHandler.rxBuf)
+            return readLine(tcpHandler.client, buf, bufLen);
+
+        int idx = 0;
+        while (idx < bufLen && fillRxBuffer(tcpHandler) > 0)
+        {
+            int len = tcpHandler.rxEnd - tcpHandler.rxPos;
+            if (len > bufLen - idx)
+                len = bufLen - idx;
+
+            const char *src = tcpHandler.rxBuf + tcpHandler.rxPos;
+            const char *eol = (const char *)memchr(src, '\n', len);
+            if (eol)
+                len = eol - src + 1;
+
+            memcpy(buf + idx, src, len);
+            idx += len;
+            tcpHandler.rxPos += len;
+
+            if (eol)
+                break;
+        }
+        return idx;
+    }
+
+    inline int readLine(struct gforms_tcp_response_handler_t &tcpHandler, MB_String &buf)
+    {
+        if (!tcpHandler.rxBuf)
+            return readLine(tcpHandler.client, buf);
+
+        int idx = 0;
+        while (fillRxBuffer(tcpHandler) > 0)
+        {
+            int len = tcpHandler.rxEnd - tcpHandler.rxPos;
+            const char *src = tcpHandler.rxBuf + tcpHandler.rxPos;
+            const char *eol = (const char *)memchr(src, '\n', len);
+            if (eol)
+                len = eol - src + 1;
+
+            buf.append(src, len);
+            idx += len;
+            tcpHandler.rxPos += len;
+
+            if (eol)
+                break;
+        }
+        return idx;
+    }
+
     inline uint32_t hex2int(const char *hex)
     {
         uint32_t val = 0;
@@ -1314,11 +1779,11 @@ namespace HttpHelper
             int readLen = 0;
 
             if (out2)
-                readLen = readLine(client, s);
+                readLen = readLine(tcpHandler, s);
             else if (out1)
             {
                 buf = MemoryHelper::createBuffer<char *>(mbfs, bufLen);
-                readLen = readLine(client, buf, bufLen);
+                readLen = readLine(tcpHandler, buf, bufLen);
             }
 
             if (readLen)
@@ -1361,11 +1826,11 @@ namespace HttpHelper
                 int readLen = 0;
 
                 if (out2)
-                    readLen = readLine(client, s);
+                    readLen = readLine(tcpHandler, s);
                 else if (out1)
                 {
                     buf = MemoryHelper::createBuffer<char *>(mbfs, bufLen);
-                    readLen = readLine(client, buf, bufLen);
+                    readLen = readLine(tcpHandler, buf, bufLen);
                 }
 
                 if (readLen > 0)
@@ -1408,6 +1873,26 @@ namespace HttpHelper
         return olen;
     }
 
+    // Read the remaining CRLF (and trailer fields) after the last chunk until the empty line,
+    // within the server response timeout of the response that was started at dataTime
+    inline void readChunkedTrailer(struct gforms_tcp_response_handler_t &tcpHandler, unsigned long timeout)
+    {
+        MB_String line;
+        while (millis() - tcpHandler.dataTime < timeout)
+        {
+            if (readLine(tcpHandler, line) > 0 && line[line.length() - 1] == '\n')
+            {
+                if (line.length() <= 2)
+                    break;
+                line.clear();
+            }
+            else if (!tcpHandler.client->connected())
+                break;
+            else
+                Utils::idle();
+        }
+    }
+
     inline bool readStatusLine(MB_FS *mbfs, Client *client, struct gforms_tcp_response_handler_t &tcpHandler,
                                struct gforms_server_response_data_t &response)
     {
@@ -1421,7 +1906,7 @@ namespace HttpHelper
 
         // the first chunk (line) can be http response status or already connected stream payload
         char *hChunk = MemoryHelper::createBuffer<char *>(mbfs, tcpHandler.chunkBufSize);
-        int readLen = readLine(client, hChunk, tcpHandler.chunkBufSize);
+        int readLen = readLine(tcpHandler, hChunk, tcpHandler.chunkBufSize);
         if (readLen > 0)
             tcpHandler.header += hChunk;
 
@@ -1444,7 +1929,7 @@ namespace HttpHelper
         // do not check of the config here to allow legacy fcm to work
 
         char *hChunk = MemoryHelper::createBuffer<char *>(mbfs, tcpHandler.chunkBufSize);
-        int readLen = readLine(client, hChunk, tcpHandler.chunkBufSize);
+        int readLen = readLine(tcpHandler, hChunk, tcpHandler.chunkBufSize);
 
         // check is it the end of http header (\n or \r\n)?
         if ((readLen == 1 && hChunk[0] == '\r') || (readLen == 2 && hChunk[0] == '\r' && hChunk[1] == '\n'))
@@ -1483,8 +1968,9 @@ namespace Utils
     {
         if (millis() - tcpHandler->dataTime > 5000)
         {
-            // Read all remaining data
-            tcpHandler->client->flush();
+            // Read all remaining data, the data of next pipelined response is kept
+            if (!tcpHandler->keepData)
+                tcpHandler->client->flush();
             complete = true;
         }
         return complete;
@@ -1495,8 +1981,9 @@ namespace Utils
         if (check && !response->isChunkedEnc &&
             (tcpHandler->bufferAvailable < 0 || tcpHandler->payloadRead >= response->contentLen))
         {
-            // Read all remaining data
-            tcpHandler->client->flush();
+            // Read all remaining data, the data of next pipelined response is kept
+            if (!tcpHandler->keepData)
+                tcpHandler->client->flush();
             complete = true;
         }
         return complete;
@@ -1506,8 +1993,9 @@ namespace Utils
     {
         if (response->isChunkedEnc && tcpHandler->bufferAvailable < 0)
         {
-            // Read all remaining data
-            tcpHandler->client->flush();
+            // Read all remaining data, the data of next pipelined response is kept
+            if (!tcpHandler->keepData)
+                tcpHandler->client->flush();
             complete = true;
         }
         return complete;
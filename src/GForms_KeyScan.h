@@ -0,0 +1,129 @@
+#ifndef GFORMS_KEY_SCAN_H
+#define GFORMS_KEY_SCAN_H
+
+// The key value scanner of the response chunks, it needs only MB_String so that it is also built on host (extras/test)
+
+#include <Arduino.h>
+#include "json/MB_String.h"
+
+typedef enum
+{
+    gforms_key_scan_step_outside,
+    gforms_key_scan_step_string,
+    gforms_key_scan_step_colon,
+    gforms_key_scan_step_value_begin,
+    gforms_key_scan_step_value
+} gforms_key_scan_step;
+
+struct gforms_key_scan_state_t
+{
+    gforms_key_scan_step step = gforms_key_scan_step_outside;
+    // the number of key characters matched in current string, -1 if not matched
+    int matched = 0;
+    bool escape = false;
+    // the output length before the current value was appended
+    size_t valueOfs = 0;
+};
+
+namespace JsonStreamHelper
+{
+
+    // Scan the chunk for the string values of key and append them to out (comma separated).
+    // The partial key or value at the end of chunk is continued in the next call.
+    inline void scanKey(gforms_key_scan_state_t &state, const char *key, size_t keyLen, const char *buf, size_t len, MB_String &out)
+    {
+        size_t i = 0;
+
+        while (i < len)
+        {
+            char c = buf[i++];
+
+            switch (state.step)
+            {
+            case gforms_key_scan_step_outside:
+                if (c == '"')
+                {
+                    state.step = gforms_key_scan_step_string;
+                    state.matched = 0;
+                    state.escape = false;
+                }
+                break;
+
+            case gforms_key_scan_step_string:
+                if (state.escape)
+                {
+                    state.escape = false;
+                    state.matched = -1;
+                }
+                else if (c == '\\')
+                    state.escape = true;
+                else if (c == '"')
+                    state.step = state.matched == (int)keyLen ? gforms_key_scan_step_colon : gforms_key_scan_step_outside;
+                else if (state.matched > -1 && state.matched < (int)keyLen && c == key[state.matched])
+                    state.matched++;
+                else
+                    state.matched = -1;
+                break;
+
+            case gforms_key_scan_step_colon:
+                if (c == ':')
+                    state.step = gforms_key_scan_step_value_begin;
+                else if (c == '"')
+                {
+                    // the string was a value, this quote begins the next string
+                    state.step = gforms_key_scan_step_string;
+                    state.matched = 0;
+                }
+                else if (c != ' ' && c != '\t' && c != '\r' && c != '\n')
+                    state.step = gforms_key_scan_step_outside;
+                break;
+
+            case gforms_key_scan_step_value_begin:
+                if (c == '"')
+                {
+                    state.step = gforms_key_scan_step_value;
+                    state.escape = false;
+                    state.valueOfs = out.length();
+                    if (state.valueOfs > 0)
+                        out += ',';
+                }
+                // not a string value
+                else if (c != ' ' && c != '\t' && c != '\r' && c != '\n')
+                    state.step = gforms_key_scan_step_outside;
+                break;
+
+            case gforms_key_scan_step_value:
+                if (state.escape)
+                {
+                    state.escape = false;
+                    out += c;
+                }
+                else if (c == '\\')
+                    state.escape = true;
+                else if (c == '"')
+                {
+                    // remove the separator of empty value
+                    if (out.length() == state.valueOfs + (state.valueOfs > 0 ? 1 : 0))
+                        out.erase(state.valueOfs);
+                    state.step = gforms_key_scan_step_outside;
+                }
+                else
+                {
+                    // copy the rest of value in this chunk at once
+                    size_t n = 0;
+                    while (i + n < len && buf[i + n] != '"' && buf[i + n] != '\\')
+                        n++;
+                    out.append(buf + i - 1, n + 1);
+                    i += n;
+                }
+                break;
+
+            default:
+                break;
+            }
+        }
+    }
+
+};
+
+#endif
\ No newline at end of file
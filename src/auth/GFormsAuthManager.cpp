@@ -49,16 +49,33 @@ void GAuthManager::begin(gauth_cfg_t *cfg, MB_FS *mbfs, uint32_t *mb_ts, uint32_
     this->mbfs = mbfs;
     this->mb_ts = mb_ts;
     this->mb_ts_offset = mb_ts_offset;
+
+    // the credentials may be changed
+    freeParsedKey();
 }
 
 void GAuthManager::end()
 {
+    setBackgroundRefresh(false);
+#if defined(GFORMS_BACKGROUND_TOKEN_REFRESH)
+    if (tokenMutex)
+        vSemaphoreDelete(tokenMutex);
+    tokenMutex = nullptr;
+#endif
     freeJson();
+    freeParsedKey();
+    endPipeline();
 #if defined(HAS_WIFIMULTI)
     if (multi)
         delete multi;
     multi = nullptr;
 #endif
+    for (int i = 0; i < gforms_pool_host_max; i++)
+    {
+        if (pool[i].client == tcpClient)
+            tcpClient = nullptr;
+        freeClient(&pool[i].client);
+    }
     if (tcpClient)
         freeClient(&tcpClient);
 }
@@ -81,6 +98,96 @@ void GAuthManager::freeClient(GFORMS_TCP_Client **client)
     *client = nullptr;
 }
 
+GFORMS_TCP_Client *GAuthManager::useClient(gforms_pool_host host, bool newRequest)
+{
+#if defined(ESP_GOOGLE_FORMS_CLIENT_ENABLE_EXTERNAL_CLIENT)
+    // the external client is shared by all hosts
+    struct gforms_pooled_client_t &slot = pool[0];
+#else
+    struct gforms_pooled_client_t &slot = pool[host];
+#endif
+
+    if (!slot.client)
+    {
+        bool pooled = false;
+        for (int i = 0; i < gforms_pool_host_max; i++)
+        {
+            if (tcpClient && pool[i].client == tcpClient)
+                pooled = true;
+        }
+
+        // the client that was created before using the pool becomes the first pooled client
+        if (tcpClient && !pooled)
+            slot.client = tcpClient;
+        else
+        {
+            newClient(&slot.client);
+            slot.client->setConfig(config, mbfs);
+        }
+    }
+
+    closeIdleClients();
+
+    // the connection to other host can't be reused
+    if (slot.host != host && slot.client->connected())
+        slot.client->stop();
+
+    slot.host = host;
+
+    if (!slot.client->connected())
+    {
+        slot.requests = 0;
+
+        // close the least recently used connection when the new connection is exceeded the limit
+        int opened = 0, lru = -1;
+        for (int i = 0; i < gforms_pool_host_max; i++)
+        {
+            if (&pool[i] != &slot && pool[i].client && pool[i].client->connected())
+            {
+                opened++;
+                if (lru < 0 || millis() - pool[i].lastMillis > millis() - pool[lru].lastMillis)
+                    lru = i;
+            }
+        }
+
+        if (opened >= GFORMS_MAX_POOL_CONNECTIONS && lru > -1)
+            pool[lru].client->stop();
+    }
+
+    if (newRequest)
+        slot.requests++;
+
+    slot.lastMillis = millis();
+    tcpClient = slot.client;
+
+    return tcpClient;
+}
+
+void GAuthManager::idleClient(GFORMS_TCP_Client *client)
+{
+    for (int i = 0; i < gforms_pool_host_max; i++)
+    {
+        if (pool[i].client == client)
+            pool[i].lastMillis = millis();
+    }
+}
+
+void GAuthManager::closeIdleClients()
+{
+    for (int i = 0; i < gforms_pool_host_max; i++)
+    {
+        struct gforms_pooled_client_t &slot = pool[i];
+
+        // the server may close the idle connection while the request is being sent
+        if (slot.client && slot.client->connected() &&
+            (millis() - slot.lastMillis > GFORMS_KEEP_ALIVE_TIMEOUT || slot.requests >= GFORMS_KEEP_ALIVE_MAX_REQUESTS))
+        {
+            slot.client->stop();
+            slot.requests = 0;
+        }
+    }
+}
+
 bool GAuthManager::parseSAFile()
 {
     if (config->signer.pk.length() > 0)
@@ -109,6 +216,9 @@ bool GAuthManager::parseSAFile()
         {
             if (resultPtr->to<MB_String>().find(pgm2Str(gauth_pgm_str_2 /* service_account */), 0) != MB_String::npos)
             {
+                // the credentials are copied by background token refresher
+                lockToken();
+
                 if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_3)) // project_id
                     config->service_account.data.project_id = resultPtr->to<const char *>();
 
@@ -140,6 +250,8 @@ bool GAuthManager::parseSAFile()
                 if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_7)) // client_id
                     config->service_account.data.client_id = resultPtr->to<const char *>();
 
+                unlockToken();
+
                 freeJson();
 
                 MemoryHelper::freeBuffer(mbfs, buf);
@@ -156,18 +268,49 @@ bool GAuthManager::parseSAFile()
     return false;
 }
 
+bool GAuthManager::parsedKeyReady()
+{
+#if defined(ESP32)
+    return config && config->signer.pk_ctx;
+#elif defined(ESP8266) || defined(MB_ARDUINO_PICO)
+    return parsedKey;
+#else
+    return false;
+#endif
+}
+
+void GAuthManager::freeParsedKey()
+{
+#if defined(ESP32)
+    if (config && config->signer.pk_ctx)
+    {
+        mbedtls_pk_free(config->signer.pk_ctx);
+        delete config->signer.pk_ctx;
+        config->signer.pk_ctx = nullptr;
+    }
+#elif defined(ESP8266) || defined(MB_ARDUINO_PICO)
+    if (parsedKey)
+        delete parsedKey;
+    parsedKey = nullptr;
+#endif
+}
+
 void GAuthManager::clearServiceAccountCreds()
 {
+    // the credentials are copied by background token refresher
+    lockToken();
     config->service_account.data.private_key = "";
     config->service_account.data.project_id.clear();
     config->service_account.data.private_key_id.clear();
     config->service_account.data.client_email.clear();
     config->signer.pk.clear();
+    unlockToken();
+    config->signer.jwtPrefix.clear();
 }
 
 bool GAuthManager::serviceAccountCredsReady()
 {
-    return (strlen_P(config->service_account.data.private_key) > 0 || config->signer.pk.length() > 0) &&
+    return (strlen_P(config->service_account.data.private_key) > 0 || config->signer.pk.length() > 0 || parsedKeyReady()) &&
            config->service_account.data.client_email.length() > 0 &&
            config->service_account.data.project_id.length() > 0;
 }
@@ -329,7 +472,7 @@ bool GAuthManager::handleToken()
             {
                 bool use_sa_key_file = false, valid_key_file = false;
                 // If service account key json file assigned and no private key parsing data
-                if (config->service_account.json.path.length() > 0 && config->signer.pk.length() == 0)
+                if (config->service_account.json.path.length() > 0 && config->signer.pk.length() == 0 && !parsedKeyReady())
                 {
                     use_sa_key_file = true;
                     // Parse the private key from service account json file
@@ -489,7 +632,17 @@ void GAuthManager::tokenProcessingTask()
             config->internal.last_jwt_begin_step_millis = millis();
 
             if (config->internal.clock_rdy)
-                config->signer.step = gauth_jwt_generation_step_encode_header_payload;
+            {
+                // The token from cache file is still valid, no JWT signing and token request required
+                if (useTokenCache())
+                {
+                    _token_processing_task_enable = false;
+                    handleTaskError(GFORMS_ERROR_TOKEN_COMPLETE_NOTIFY);
+                    ret = true;
+                }
+                else
+                    config->signer.step = gauth_jwt_generation_step_encode_header_payload;
+            }
         }
         // encode the JWT token
         else if (config->signer.step == gauth_jwt_generation_step_encode_header_payload)
@@ -574,7 +727,7 @@ bool GAuthManager::refreshToken()
 
     int httpCode = GFORMS_ERROR_HTTP_CODE_REQUEST_TIMEOUT;
     MB_String payload;
-    if (handleResponse(tcpClient, httpCode, payload))
+    if (handleTokenResponse(httpCode, payload))
     {
         if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_14 /* "error/code" */))
         {
@@ -721,37 +874,84 @@ MB_String GAuthManager::getValue(MB_String &response, const char *key)
     return MB_String();
 }
 
-bool GAuthManager::handleResponse(GFORMS_TCP_Client *client, int &httpCode, MB_String &payload, const char *key, bool stopSession)
+bool GAuthManager::handleResponse(GFORMS_TCP_Client *client, int &httpCode, MB_String &payload, const char *key, bool stopSession,
+                                  gforms_json_stream_state_t *stream)
 {
-    if (!reconnect(client))
+    struct gforms_response_reader_t reader;
+
+    if (!beginResponse(client, reader, key, stream))
+        return false;
+
+    int ret = 0;
+    while ((ret = readResponse(client, reader, payload)) == 0)
+        Utils::idle();
+
+    // no response
+    if (ret < 0 && !reader.started)
+    {
+        freeResponse(reader);
         return false;
+    }
+
+    return completeResponse(client, reader, httpCode, payload, stopSession);
+}
 
-    MB_String header;
+bool GAuthManager::beginResponse(GFORMS_TCP_Client *client, struct gforms_response_reader_t &reader, const char *key,
+                                 gforms_json_stream_state_t *stream)
+{
+    if (!reconnect(client))
+        return false;
 
-    struct gforms_server_response_data_t response;
-    struct gforms_tcp_response_handler_t tcpHandler;
+    struct gforms_tcp_response_handler_t &tcpHandler = reader.tcpHandler;
 
-    HttpHelper::intTCPHandler(client, tcpHandler, 2048, 2048, nullptr);
+    HttpHelper::intTCPHandler(client, tcpHandler, GFORMS_RESPONSE_CHUNK_SIZE, GFORMS_RESPONSE_CHUNK_SIZE, nullptr);
 
-    while (client->connected() && client->available() == 0)
+    // Read the data from client in bulk instead of byte by byte,
+    // the pipelined responses share the receive buffer that may hold the next response data
+    tcpHandler.rxBufLen = GFORMS_RESPONSE_RX_BUFFER_SIZE;
+    if (pipeRxBuf)
     {
-        Utils::idle();
-        if (!reconnect(client, tcpHandler.dataTime))
-            return false;
+        tcpHandler.rxBuf = pipeRxBuf;
+        tcpHandler.rxPos = pipeRxPos;
+        tcpHandler.rxEnd = pipeRxEnd;
+        tcpHandler.keepData = true;
     }
-
-    bool complete = false;
+    else
+        tcpHandler.rxBuf = MemoryHelper::createBuffer<char *>(mbfs, tcpHandler.rxBufLen, false);
 
     tcpHandler.chunkBufSize = tcpHandler.defaultChunkSize;
 
-    char *pChunk = MemoryHelper::createBuffer<char *>(mbfs, tcpHandler.chunkBufSize + 1);
+    // The pipelined responses share the chunk buffer
+    reader.chunk = pipeChunk ? pipeChunk : MemoryHelper::createBuffer<char *>(mbfs, tcpHandler.chunkBufSize + 1);
+
+    reader.key = key;
+    reader.keyLen = strlen(key);
+    reader.stream = stream;
+
+    return true;
+}
+
+int GAuthManager::readResponse(GFORMS_TCP_Client *client, struct gforms_response_reader_t &reader, MB_String &payload, int maxReads)
+{
+    struct gforms_tcp_response_handler_t &tcpHandler = reader.tcpHandler;
+    struct gforms_server_response_data_t &response = reader.response;
 
-    while (tcpHandler.available() || !complete)
+    // wait for the response data
+    if (!reader.started)
+    {
+        if (client->connected() && tcpHandler.available() == 0)
+            return reconnect(client, tcpHandler.dataTime) ? 0 : -1;
+        reader.started = true;
+    }
+
+    int reads = 0;
+
+    while (tcpHandler.available() || !reader.complete)
     {
         Utils::idle();
 
         if (!reconnect(client, tcpHandler.dataTime))
-            break;
+            return -1;
 
         if (!HttpHelper::readStatusLine(mbfs, client, tcpHandler, response))
         {
@@ -765,11 +965,12 @@ bool GAuthManager::handleResponse(GFORMS_TCP_Client *client, int &httpCode, MB_S
                         tcpHandler.error.code = 0;
 
                     if (Utils::isNoContent(&response))
-                        break;
+                        return 1;
                 }
             }
             else
             {
+                char *pChunk = reader.chunk;
                 memset(pChunk, 0, tcpHandler.chunkBufSize + 1);
 
                 // Read the avilable data
@@ -778,49 +979,72 @@ bool GAuthManager::handleResponse(GFORMS_TCP_Client *client, int &httpCode, MB_S
                     tcpHandler.bufferAvailable = HttpHelper::readChunkedData(mbfs, client,
                                                                              pChunk, nullptr, tcpHandler);
                 else
-                    tcpHandler.bufferAvailable = HttpHelper::readLine(client,
-                                                                      pChunk, tcpHandler.chunkBufSize);
+                {
+                    // Do not read beyond the content, it can be the next pipelined response
+                    int len = tcpHandler.chunkBufSize;
+                    if (response.contentLen - tcpHandler.payloadRead < len)
+                        len = response.contentLen - tcpHandler.payloadRead;
+                    tcpHandler.bufferAvailable = HttpHelper::readLine(tcpHandler, pChunk, len);
+                }
 
                 if (tcpHandler.bufferAvailable > 0)
                 {
                     tcpHandler.payloadRead += tcpHandler.bufferAvailable;
-                    if (strlen(key) == 0)
-                        payload += pChunk;
-                    else
-                    {
 
-                        MB_String res, _pChunk = pChunk;
-                        res = getValue(_pChunk, key);
-                        if (res.length() > 0)
-                        {
-                            if (payload.length() > 0)
-                                payload += ",";
-                            payload += res;
-                        }
-                    }
+                    // Parse the payload on the fly instead of keeping it, the error payload is kept as usual
+                    if (reader.stream && response.httpCode == GFORMS_ERROR_HTTP_CODE_OK)
+                        JsonStreamHelper::parse(*reader.stream, pChunk, strlen(pChunk));
+                    else if (reader.keyLen > 0 && response.httpCode == GFORMS_ERROR_HTTP_CODE_OK)
+                        JsonStreamHelper::scanKey(reader.keyScan, reader.key, reader.keyLen, pChunk, strlen(pChunk), payload);
+                    else
+                        payload += pChunk;
                 }
 
-                if (Utils::isChunkComplete(&tcpHandler, &response, complete) ||
-                    Utils::isResponseComplete(&tcpHandler, &response, complete))
-                {
-
-                    break;
-                }
+                if (Utils::isChunkComplete(&tcpHandler, &response, reader.complete) ||
+                    Utils::isResponseComplete(&tcpHandler, &response, reader.complete))
+                    return 1;
             }
         }
+
+        // resume in the next call when the read limit was reached or no data to read
+        if (maxReads > 0 && (++reads == maxReads || tcpHandler.available() == 0))
+            return 0;
     }
 
+    return 1;
+}
+
+bool GAuthManager::completeResponse(GFORMS_TCP_Client *client, struct gforms_response_reader_t &reader, int &httpCode,
+                                    MB_String &payload, bool stopSession)
+{
+    struct gforms_tcp_response_handler_t &tcpHandler = reader.tcpHandler;
+    struct gforms_server_response_data_t &response = reader.response;
+
     // To make sure all chunks read
     if (response.isChunkedEnc)
-        client->flush();
+    {
+        if (tcpHandler.keepData)
+            HttpHelper::readChunkedTrailer(tcpHandler, serverResponseTimeout());
+        else
+            client->flush();
+    }
+
+    freeResponse(reader);
 
-    MemoryHelper::freeBuffer(mbfs, pChunk);
+    // the server will close the connection
+    if (strcmp(response.connection.c_str(), (const char *)FPSTR("close")) == 0)
+        stopSession = true;
 
     if (stopSession && client->connected())
         client->stop();
+    else
+        idleClient(client);
 
     httpCode = response.httpCode;
 
+    if (reader.stream && httpCode == GFORMS_ERROR_HTTP_CODE_OK)
+        return JsonStreamHelper::end(*reader.stream);
+
     if (jsonPtr && payload.length() > 0 && !response.noContent)
     {
         // Just a simple JSON which is suitable for parsing in low memory device
@@ -831,6 +1055,60 @@ bool GAuthManager::handleResponse(GFORMS_TCP_Client *client, int &httpCode, MB_S
     return httpCode == GFORMS_ERROR_HTTP_CODE_OK;
 }
 
+bool GAuthManager::handleTokenResponse(int &httpCode, MB_String &payload)
+{
+    // The token response payload is not used after the JSON, parse it in place here instead of copying in handleResponse
+    FirebaseJson *json = jsonPtr;
+    jsonPtr = nullptr;
+    bool ret = handleResponse(tcpClient, httpCode, payload);
+    jsonPtr = json;
+
+    if (jsonPtr && payload.length() > 0)
+    {
+        jsonPtr->setJsonDataInSitu(payload);
+        return true;
+    }
+
+    return ret;
+}
+
+void GAuthManager::freeResponse(struct gforms_response_reader_t &reader)
+{
+    if (reader.chunk != pipeChunk)
+        MemoryHelper::freeBuffer(mbfs, reader.chunk);
+    reader.chunk = nullptr;
+    endResponse(reader.tcpHandler);
+}
+
+void GAuthManager::endResponse(struct gforms_tcp_response_handler_t &tcpHandler)
+{
+    if (tcpHandler.rxBuf == pipeRxBuf)
+    {
+        pipeRxPos = tcpHandler.rxPos;
+        pipeRxEnd = tcpHandler.rxEnd;
+    }
+    else
+        MemoryHelper::freeBuffer(mbfs, tcpHandler.rxBuf);
+    tcpHandler.rxBuf = nullptr;
+}
+
+void GAuthManager::beginPipeline()
+{
+    endPipeline();
+    pipeRxBuf = MemoryHelper::createBuffer<char *>(mbfs, GFORMS_RESPONSE_RX_BUFFER_SIZE, false);
+    pipeChunk = MemoryHelper::createBuffer<char *>(mbfs, GFORMS_RESPONSE_CHUNK_SIZE + 1);
+}
+
+void GAuthManager::endPipeline()
+{
+    MemoryHelper::freeBuffer(mbfs, pipeRxBuf);
+    pipeRxBuf = nullptr;
+    MemoryHelper::freeBuffer(mbfs, pipeChunk);
+    pipeChunk = nullptr;
+    pipeRxPos = 0;
+    pipeRxEnd = 0;
+}
+
 bool GAuthManager::createJWT()
 {
     if (config->signer.step == gauth_jwt_generation_step_encode_header_payload)
@@ -843,62 +1121,38 @@ bool GAuthManager::createJWT()
 
         time_t now = getTime();
 
-        initJson();
-
-        config->signer.tokens.jwt.clear();
-
-        // header
-        // {"alg":"RS256","typ":"JWT"}
-        jsonPtr->add(pgm2Str(gauth_pgm_str_20 /* "alg" */), pgm2Str(gauth_pgm_str_21 /* "RS256" */));
-        jsonPtr->add(pgm2Str(gauth_pgm_str_22 /* "typ" */), pgm2Str(gauth_pgm_str_23 /* "JWT" */));
+        if (config->signer.jwtPrefix.length() == 0 || config->signer.jwtIdentity != config->service_account.data.client_email)
+            createJWTPrefix();
 
-        size_t len = Base64Helper::encodedLength(strlen(jsonPtr->raw()));
-        char *buf = MemoryHelper::createBuffer<char *>(mbfs, len);
-        Base64Helper::encodeUrl(mbfs, buf, (unsigned char *)jsonPtr->raw(), strlen(jsonPtr->raw()));
-        config->signer.encHeader = buf;
-        MemoryHelper::freeBuffer(mbfs, buf);
-        config->signer.encHeadPayload = config->signer.encHeader;
-
-        // payload
-        // {"iss":"<email>","sub":"<email>","aud":"<audience>","iat":<timstamp>,"exp":<expire>,"scope":"<scope>"}
-        // {"iss":"<email>","sub":"<email>","aud":"<audience>","iat":<timstamp>,"exp":<expire>,"uid":"<uid>","claims":"<claims>"}
-        jsonPtr->clear();
-        jsonPtr->add(pgm2Str(gauth_pgm_str_24 /* "iss" */), config->service_account.data.client_email.c_str());
-        jsonPtr->add(pgm2Str(gauth_pgm_str_25 /* "sub" */), config->service_account.data.client_email.c_str());
-
-        MB_String t = gauth_pgm_str_26; // "https://"
-        HttpHelper::addGAPIsHost(t, gauth_pgm_str_27 /* "oauth2" */);
-        t += gauth_pgm_str_28; // "/"
-        t += gauth_pgm_str_29; // "token"
-
-        jsonPtr->add(pgm2Str(gauth_pgm_str_30 /* "aud" */), t.c_str());
-        jsonPtr->add(pgm2Str(gauth_pgm_str_31 /* "iat" */), (int)now);
-
-        if (config->signer.expiredSeconds > 3600)
-            jsonPtr->add(pgm2Str(gauth_pgm_str_32 /* "exp" */), (int)(now + 3600));
-        else
-            jsonPtr->add(pgm2Str(gauth_pgm_str_32 /* "exp" */), (int)(now + config->signer.expiredSeconds));
-
-        jsonPtr->add(pgm2Str(gauth_pgm_str_33 /* "scope" */), pgm2Str(gauth_pgm_str_34));
-
-        len = Base64Helper::encodedLength(strlen(jsonPtr->raw()));
-        buf = MemoryHelper::createBuffer<char *>(mbfs, len);
-        Base64Helper::encodeUrl(mbfs, buf, (unsigned char *)jsonPtr->raw(), strlen(jsonPtr->raw()));
-        config->signer.encPayload = buf;
-        MemoryHelper::freeBuffer(mbfs, buf);
+        // the claims that change on every signing, following the bytes of constant claims which were not encoded
+        // "iat":<timstamp>,"exp":<expire>}
+        char claims[64];
+        int exp = config->signer.expiredSeconds > 3600 ? 3600 : config->signer.expiredSeconds;
+        int len = snprintf(claims, sizeof(claims), "%s\"%s\":%d,\"%s\":%d}", config->signer.jwtPrefixTail.c_str(),
+                           pgm2Str(gauth_pgm_str_31 /* "iat" */), (int)now,
+                           pgm2Str(gauth_pgm_str_32 /* "exp" */), (int)(now + exp));
 
-        config->signer.encHeadPayload += gauth_pgm_str_35; // "."
-        config->signer.encHeadPayload += config->signer.encPayload;
+        char encClaims[96];
+        Base64Helper::encodeUrl(mbfs, encClaims, (unsigned char *)claims, len);
 
-        config->signer.encHeader.clear();
-        config->signer.encPayload.clear();
+        config->signer.tokens.jwt = config->signer.jwtPrefix;
+        config->signer.tokens.jwt += encClaims;
 
 // create message digest from encoded header and payload
 #if defined(ESP32)
         config->signer.hash = MemoryHelper::createBuffer<uint8_t *>(mbfs, config->signer.hashSize);
-        int ret = mbedtls_md(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256),
-                             (const unsigned char *)config->signer.encHeadPayload.c_str(),
-                             config->signer.encHeadPayload.length(), config->signer.hash);
+        mbedtls_md_context_t mc;
+        mbedtls_md_init(&mc);
+        int ret = mbedtls_md_setup(&mc, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 0);
+        if (ret == 0)
+            ret = mbedtls_md_starts(&mc);
+        if (ret == 0)
+            ret = mbedtls_md_update(&mc, (const unsigned char *)config->signer.jwtPrefix.c_str(), config->signer.jwtPrefix.length());
+        if (ret == 0)
+            ret = mbedtls_md_update(&mc, (const unsigned char *)encClaims, strlen(encClaims));
+        if (ret == 0)
+            ret = mbedtls_md_finish(&mc, config->signer.hash);
+        mbedtls_md_free(&mc);
         if (ret != 0)
         {
             char *temp = MemoryHelper::createBuffer<char *>(mbfs, 100);
@@ -909,40 +1163,42 @@ bool GAuthManager::createJWT()
             setTokenError(GFORMS_ERROR_TOKEN_CREATE_HASH);
             sendTokenStatusCB();
             MemoryHelper::freeBuffer(mbfs, config->signer.hash);
+            config->signer.tokens.jwt.clear();
             return false;
         }
 #elif defined(ESP8266) || defined(MB_ARDUINO_PICO)
         config->signer.hash = MemoryHelper::createBuffer<char *>(mbfs, config->signer.hashSize);
         br_sha256_context mc;
         br_sha256_init(&mc);
-        br_sha256_update(&mc, config->signer.encHeadPayload.c_str(), config->signer.encHeadPayload.length());
+        br_sha256_update(&mc, config->signer.jwtPrefix.c_str(), config->signer.jwtPrefix.length());
+        br_sha256_update(&mc, encClaims, strlen(encClaims));
         br_sha256_out(&mc, config->signer.hash);
 #endif
 
-        config->signer.tokens.jwt = config->signer.encHeadPayload;
         config->signer.tokens.jwt += gauth_pgm_str_35; // "."
-        config->signer.encHeadPayload.clear();
-
-        freeJson();
     }
     else if (config->signer.step == gauth_jwt_generation_step_sign)
     {
         config->signer.tokens.status = token_status_on_signing;
 
 #if defined(ESP32)
-        config->signer.pk_ctx = new mbedtls_pk_context();
-        mbedtls_pk_init(config->signer.pk_ctx);
-
-        // parse priv key
         int ret = 0;
-        if (config->signer.pk.length() > 0)
-            ret = mbedtls_pk_parse_key(config->signer.pk_ctx,
-                                       (const unsigned char *)config->signer.pk.c_str(),
-                                       config->signer.pk.length() + 1, NULL, 0);
-        else if (strlen_P(config->service_account.data.private_key) > 0)
-            ret = mbedtls_pk_parse_key(config->signer.pk_ctx,
-                                       (const unsigned char *)config->service_account.data.private_key,
-                                       strlen_P(config->service_account.data.private_key) + 1, NULL, 0);
+
+        // parse priv key if the parsed key from previous signing was not kept
+        if (!config->signer.pk_ctx)
+        {
+            config->signer.pk_ctx = new mbedtls_pk_context();
+            mbedtls_pk_init(config->signer.pk_ctx);
+
+            if (config->signer.pk.length() > 0)
+                ret = mbedtls_pk_parse_key(config->signer.pk_ctx,
+                                           (const unsigned char *)config->signer.pk.c_str(),
+                                           config->signer.pk.length() + 1, NULL, 0);
+            else if (strlen_P(config->service_account.data.private_key) > 0)
+                ret = mbedtls_pk_parse_key(config->signer.pk_ctx,
+                                           (const unsigned char *)config->service_account.data.private_key,
+                                           strlen_P(config->service_account.data.private_key) + 1, NULL, 0);
+        }
 
         if (ret != 0)
         {
@@ -993,34 +1249,41 @@ bool GAuthManager::createJWT()
             MemoryHelper::freeBuffer(mbfs, buf);
 
             config->signer.tokens.jwt += config->signer.encSignature;
+            lockToken();
             config->signer.pk.clear();
+            unlockToken();
             config->signer.encSignature.clear();
         }
 
         MemoryHelper::freeBuffer(mbfs, config->signer.signature);
         MemoryHelper::freeBuffer(mbfs, config->signer.hash);
-        mbedtls_pk_free(config->signer.pk_ctx);
         mbedtls_entropy_free(config->signer.entropy_ctx);
         mbedtls_ctr_drbg_free(config->signer.ctr_drbg_ctx);
-        delete config->signer.pk_ctx;
         delete config->signer.entropy_ctx;
         delete config->signer.ctr_drbg_ctx;
 
-        config->signer.pk_ctx = nullptr;
+        // keep the parsed key for the next signing
+        if (!config->signer.keepParsedKey || ret != 0)
+            freeParsedKey();
+
         config->signer.entropy_ctx = nullptr;
         config->signer.ctr_drbg_ctx = nullptr;
 
         if (ret != 0)
             return false;
 #elif defined(ESP8266) || defined(MB_ARDUINO_PICO)
-        // RSA private key
-        BearSSL::PrivateKey *pk = nullptr;
+        // RSA private key, use the parsed key from previous signing if it was kept
+        BearSSL::PrivateKey *pk = parsedKey;
+        parsedKey = nullptr;
         Utils::idle();
         // parse priv key
-        if (config->signer.pk.length() > 0)
-            pk = new BearSSL::PrivateKey((const char *)config->signer.pk.c_str());
-        else if (strlen_P(config->service_account.data.private_key) > 0)
-            pk = new BearSSL::PrivateKey((const char *)config->service_account.data.private_key);
+        if (!pk)
+        {
+            if (config->signer.pk.length() > 0)
+                pk = new BearSSL::PrivateKey((const char *)config->signer.pk.c_str());
+            else if (strlen_P(config->service_account.data.private_key) > 0)
+                pk = new BearSSL::PrivateKey((const char *)config->service_account.data.private_key);
+        }
 
         if (!pk)
         {
@@ -1046,8 +1309,8 @@ bool GAuthManager::createJWT()
         config->signer.signature = new unsigned char[config->signer.signatureSize];
 
         Utils::idle();
-        int ret = br_rsa_i15_pkcs1_sign(BR_HASH_OID_SHA256, (const unsigned char *)config->signer.hash,
-                                        br_sha256_SIZE, br_rsa_key, config->signer.signature);
+        int ret = getRSASigner()(BR_HASH_OID_SHA256, (const unsigned char *)config->signer.hash,
+                                 br_sha256_SIZE, br_rsa_key, config->signer.signature);
         Utils::idle();
         MemoryHelper::freeBuffer(mbfs, config->signer.hash);
 
@@ -1057,20 +1320,27 @@ bool GAuthManager::createJWT()
         config->signer.encSignature = buf;
         MemoryHelper::freeBuffer(mbfs, buf);
         MemoryHelper::freeBuffer(mbfs, config->signer.signature);
-        delete pk;
+
+        // keep the parsed key for the next signing
+        if (config->signer.keepParsedKey && ret > 0)
+            parsedKey = pk;
+        else
+            delete pk;
         pk = nullptr;
 
         // get the signed JWT
         if (ret > 0)
         {
             config->signer.tokens.jwt += config->signer.encSignature;
+            lockToken();
             config->signer.pk.clear();
+            unlockToken();
             config->signer.encSignature.clear();
         }
         else
         {
             setTokenError(GFORMS_ERROR_TOKEN_SIGN);
-            config->signer.tokens.error.message.insert(0, (const char *)FPSTR("BearSSL, br_rsa_i15_pkcs1_sign: "));
+            config->signer.tokens.error.message.insert(0, (const char *)FPSTR("BearSSL, br_rsa_pkcs1_sign: "));
             sendTokenStatusCB();
             return false;
         }
@@ -1080,6 +1350,75 @@ bool GAuthManager::createJWT()
     return true;
 }
 
+void GAuthManager::createJWTPrefix()
+{
+    initJson();
+
+    // header
+    // {"alg":"RS256","typ":"JWT"}
+    jsonPtr->add(pgm2Str(gauth_pgm_str_20 /* "alg" */), pgm2Str(gauth_pgm_str_21 /* "RS256" */));
+    jsonPtr->add(pgm2Str(gauth_pgm_str_22 /* "typ" */), pgm2Str(gauth_pgm_str_23 /* "JWT" */));
+
+    size_t len = strlen(jsonPtr->raw());
+    char *buf = MemoryHelper::createBuffer<char *>(mbfs, Base64Helper::encodedLength(len));
+    Base64Helper::encodeUrl(mbfs, buf, (unsigned char *)jsonPtr->raw(), len);
+    config->signer.jwtPrefix = buf;
+    config->signer.jwtPrefix += gauth_pgm_str_35; // "."
+    MemoryHelper::freeBuffer(mbfs, buf);
+
+    // constant claims, the iat and exp claims will be appended on signing
+    // {"iss":"<email>","sub":"<email>","aud":"<audience>","scope":"<scope>",
+    jsonPtr->clear();
+    jsonPtr->add(pgm2Str(gauth_pgm_str_24 /* "iss" */), config->service_account.data.client_email.c_str());
+    jsonPtr->add(pgm2Str(gauth_pgm_str_25 /* "sub" */), config->service_account.data.client_email.c_str());
+
+    MB_String t = gauth_pgm_str_26; // "https://"
+    HttpHelper::addGAPIsHost(t, gauth_pgm_str_27 /* "oauth2" */);
+    t += gauth_pgm_str_28; // "/"
+    t += gauth_pgm_str_29; // "token"
+
+    jsonPtr->add(pgm2Str(gauth_pgm_str_30 /* "aud" */), t.c_str());
+    jsonPtr->add(pgm2Str(gauth_pgm_str_33 /* "scope" */), pgm2Str(gauth_pgm_str_34));
+
+    // replace the closing brace with comma
+    t = jsonPtr->raw();
+    t[t.length() - 1] = ',';
+
+    // encode the complete 3 bytes groups only, the remaining bytes will be encoded with the iat and exp claims
+    len = t.length() / 3 * 3;
+    buf = MemoryHelper::createBuffer<char *>(mbfs, Base64Helper::encodedLength(len));
+    Base64Helper::encodeUrl(mbfs, buf, (unsigned char *)t.c_str(), len);
+    config->signer.jwtPrefix += buf;
+    MemoryHelper::freeBuffer(mbfs, buf);
+
+    config->signer.jwtPrefixTail = t.c_str() + len;
+    config->signer.jwtIdentity = config->service_account.data.client_email;
+
+    freeJson();
+}
+
+#if defined(ESP8266) || defined(MB_ARDUINO_PICO)
+br_rsa_pkcs1_sign GAuthManager::getRSASigner()
+{
+    br_rsa_pkcs1_sign signer = 0;
+#if defined(GFORMS_RSA_SIGN_ENGINE)
+#if GFORMS_RSA_SIGN_ENGINE == 15
+    signer = &br_rsa_i15_pkcs1_sign;
+#elif GFORMS_RSA_SIGN_ENGINE == 31
+    signer = &br_rsa_i31_pkcs1_sign;
+#elif GFORMS_RSA_SIGN_ENGINE == 32
+    signer = &br_rsa_i32_pkcs1_sign;
+#elif GFORMS_RSA_SIGN_ENGINE == 62
+    // i62 is available only when the compiler supports 64x64->128 multiply
+    signer = br_rsa_i62_pkcs1_sign_get();
+#endif
+#endif
+    if (!signer)
+        signer = br_rsa_pkcs1_sign_get_default();
+    return signer;
+}
+#endif
+
 bool GAuthManager::initClient(PGM_P subDomain, gauth_auth_token_status status)
 {
 
@@ -1096,7 +1435,10 @@ bool GAuthManager::initClient(PGM_P subDomain, gauth_auth_token_status status)
         sendTokenStatusCB();
     }
 
-    // stop the TCP session
+    // the token request has its own connection, the Forms and Drive connections are kept
+    useClient(gforms_pool_host_token, true);
+
+    // stop the TCP session, the token requests can be sent to different sub domains
     tcpClient->stop();
 
     tcpClient->setCACert(nullptr);
@@ -1179,7 +1521,7 @@ bool GAuthManager::requestTokens(bool refresh)
 
     int httpCode = GFORMS_ERROR_HTTP_CODE_REQUEST_TIMEOUT;
     MB_String payload;
-    if (handleResponse(tcpClient, httpCode, payload))
+    if (handleTokenResponse(httpCode, payload))
     {
 
         config->signer.tokens.jwt.clear();
@@ -1218,11 +1560,18 @@ bool GAuthManager::requestTokens(bool refresh)
         {
 
             if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_44 /* "access_token" */))
+            {
+                lockToken();
                 config->internal.auth_token = resultPtr->to<const char *>();
+                config->internal.auth_token_generation++;
+                unlockToken();
+            }
 
             if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_19 /* "expires_in" */))
                 getExpiration(resultPtr->to<const char *>());
 
+            writeTokenCache();
+
             return handleTaskError(GFORMS_ERROR_TOKEN_COMPLETE_NOTIFY);
         }
         return handleTaskError(GFORMS_ERROR_TOKEN_ERROR_UNNOTIFY);
@@ -1235,8 +1584,113 @@ void GAuthManager::getExpiration(const char *exp)
 {
     time_t now = getTime();
     unsigned long ms = millis();
+    lockToken();
     config->signer.tokens.expires = now + atoi(exp);
     config->signer.tokens.last_millis = ms;
+    unlockToken();
+}
+
+uint16_t GAuthManager::getIdentityCRC()
+{
+    // The parsed credentials whatever the source, the service account file can be replaced by another account
+    MB_String id = config->service_account.data.client_email;
+    id += config->service_account.data.private_key_id;
+    id += config->service_account.data.project_id;
+    return Utils::calCRC(mbfs, id.c_str());
+}
+
+bool GAuthManager::readTokenCache()
+{
+    config->internal.cached_token.clear();
+    config->internal.cached_expires = 0;
+    config->internal.cached_crc = 0;
+
+    if (config->token_cache.file.length() == 0)
+        return false;
+
+    int res = mbfs->open(config->token_cache.file, mbfs_type config->token_cache.storage_type, mb_fs_open_mode_read);
+
+    if (res < 0)
+        return false;
+
+    size_t len = res;
+    char *buf = MemoryHelper::createBuffer<char *>(mbfs, len + 1);
+    bool read = len > 0 && (int)len == mbfs->read(mbfs_type config->token_cache.storage_type, (uint8_t *)buf, len);
+    mbfs->close(mbfs_type config->token_cache.storage_type);
+
+    if (read)
+    {
+        initJson();
+        jsonPtr->setJsonData(buf);
+
+        // The identity is checked when the token is used, the service account file is not parsed yet
+        if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_47 /* "crc" */))
+            config->internal.cached_crc = resultPtr->to<int>();
+
+        if (config->internal.cached_crc > 0 && JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_46 /* "expires" */))
+        {
+            config->internal.cached_expires = resultPtr->to<unsigned long>();
+            if (JsonHelper::parse(jsonPtr, resultPtr, gauth_pgm_str_44 /* "access_token" */))
+                config->internal.cached_token = resultPtr->to<const char *>();
+        }
+
+        freeJson();
+    }
+
+    MemoryHelper::freeBuffer(mbfs, buf);
+
+    return config->internal.cached_token.length() > 0;
+}
+
+void GAuthManager::writeTokenCache()
+{
+    if (config->token_cache.file.length() == 0 || config->internal.auth_token.length() == 0)
+        return;
+
+    FirebaseJson json;
+    lockToken();
+    json.add(pgm2Str(gauth_pgm_str_44 /* "access_token" */), config->internal.auth_token.c_str());
+    json.add(pgm2Str(gauth_pgm_str_46 /* "expires" */), config->signer.tokens.expires);
+    unlockToken();
+    json.add(pgm2Str(gauth_pgm_str_47 /* "crc" */), (int)getIdentityCRC());
+
+    if (mbfs->open(config->token_cache.file, mbfs_type config->token_cache.storage_type, mb_fs_open_mode_write) < 0)
+        return;
+
+    mbfs->write(mbfs_type config->token_cache.storage_type, (uint8_t *)json.raw(), strlen(json.raw()));
+    mbfs->close(mbfs_type config->token_cache.storage_type);
+}
+
+bool GAuthManager::useTokenCache()
+{
+    if (config->internal.cached_token.length() == 0)
+        return false;
+
+    time_t now = getTime();
+
+    // the clock must be synched to validate the expiry timestamp,
+    // and the token must be issued for the current (parsed) service account
+    bool valid = config->service_account.data.client_email.length() > 0 &&
+                 config->internal.cached_crc == getIdentityCRC() &&
+                 (unsigned long)now > GFORMS_DEFAULT_TS &&
+                 config->internal.cached_expires > (unsigned long)now + config->signer.preRefreshSeconds;
+
+    if (valid)
+    {
+        lockToken();
+        config->internal.auth_token = config->internal.cached_token;
+        config->internal.auth_token_generation++;
+        config->signer.tokens.expires = config->internal.cached_expires;
+        config->signer.tokens.last_millis = millis();
+        unlockToken();
+    }
+
+    // use only once
+    config->internal.cached_token.clear();
+    config->internal.cached_expires = 0;
+    config->internal.cached_crc = 0;
+
+    return valid;
 }
 
 void GAuthManager::checkToken()
@@ -1244,6 +1698,43 @@ void GAuthManager::checkToken()
     if (!config)
         return;
 
+#if defined(GFORMS_BACKGROUND_TOKEN_REFRESH)
+    if (refreshTask)
+    {
+        // save and notify the token that was renewed in background
+        if (tokenRenewed)
+        {
+            tokenRenewed = false;
+            writeTokenCache();
+            config->internal.last_jwt_generation_error_cb_millis = 0;
+            sendTokenStatusCB();
+        }
+
+        // the token is being renewed in background until it was expired
+        if (config->signer.tokens.status == token_status_ready && getTime() < (time_t)config->signer.tokens.expires)
+            return;
+
+        if (!isExpired())
+            return;
+
+        // the expired token is renewed here only when no background renewal is still running
+        lockToken();
+        bool renewing = tokenRenewing;
+        tokenRenewing = true;
+        unlockToken();
+
+        if (renewing)
+            return;
+
+        handleToken();
+
+        lockToken();
+        tokenRenewing = false;
+        unlockToken();
+        return;
+    }
+#endif
+
     if (isExpired())
         handleToken();
 }
@@ -1262,6 +1753,151 @@ bool GAuthManager::tokenReady()
     return config->signer.tokens.status == token_status_ready;
 };
 
+void GAuthManager::setBackgroundRefresh(bool enable)
+{
+#if defined(GFORMS_BACKGROUND_TOKEN_REFRESH)
+    if (enable && !refreshTask)
+    {
+        refresherConfig = new gauth_cfg_t();
+        refresherFS = new MB_FS();
+        refresher = new GAuthManager();
+        refresher->begin(refresherConfig, refresherFS, mb_ts, mb_ts_offset);
+        refresher->newClient(&refresher->tcpClient);
+        refresher->tcpClient->setConfig(refresherConfig, refresherFS);
+        // the network reconnection is left to foreground
+        refresher->autoReconnectWiFi = false;
+
+        if (!tokenMutex)
+            tokenMutex = xSemaphoreCreateMutex();
+
+        refreshStop = false;
+        tokenRenewed = false;
+        tokenRenewing = false;
+        lastRenewMillis = 0;
+        xTaskCreate(refreshTaskFunc, "gformsTokenTask", GFORMS_TOKEN_REFRESH_TASK_STACK_SIZE, this, 1, &refreshTask);
+    }
+    else if (!enable && refreshTask)
+    {
+        // wake the task and wait for the running renewal to finish
+        refreshStop = true;
+        xTaskNotifyGive(refreshTask);
+        while (refreshTask)
+            delay(10);
+
+        delete refresher;
+        refresher = nullptr;
+        delete refresherConfig;
+        refresherConfig = nullptr;
+        delete refresherFS;
+        refresherFS = nullptr;
+    }
+#endif
+}
+
+#if defined(GFORMS_BACKGROUND_TOKEN_REFRESH)
+void GAuthManager::refreshTaskFunc(void *param)
+{
+    GAuthManager *auth = (GAuthManager *)param;
+
+    while (!auth->refreshStop)
+    {
+        gauth_token_signer_resources_t &signer = auth->config->signer;
+        time_t now = auth->getTime();
+
+        // renew the ready token in its pre-refresh period, the expired token is renewed by foreground
+        auth->lockToken();
+        bool renew = !auth->tokenRenewing && signer.tokens.status == token_status_ready && signer.tokens.expires > 0 &&
+                     now > (time_t)(signer.tokens.expires - signer.preRefreshSeconds) && now < (time_t)signer.tokens.expires &&
+                     (millis() - auth->lastRenewMillis > GFORMS_TOKEN_REFRESH_RETRY_INTERVAL || auth->lastRenewMillis == 0);
+        if (renew)
+            auth->tokenRenewing = true;
+        auth->unlockToken();
+
+        if (renew)
+        {
+            auth->lastRenewMillis = millis();
+            auth->renewToken();
+
+            auth->lockToken();
+            auth->tokenRenewing = false;
+            auth->unlockToken();
+        }
+
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+    }
+
+    auth->refreshTask = nullptr;
+    vTaskDelete(NULL);
+}
+
+void GAuthManager::renewToken()
+{
+    gauth_cfg_t *cfg = refresherConfig;
+
+    // the current credentials and settings, the token cache and status callback are handled by foreground
+    lockToken();
+    uint32_t generation = credsGeneration;
+    cfg->service_account = config->service_account;
+    cfg->time_zone = config->time_zone;
+    cfg->timeout = config->timeout;
+    cfg->signer.expiredSeconds = config->signer.expiredSeconds;
+    cfg->signer.keepParsedKey = config->signer.keepParsedKey;
+    cfg->signer.pk = config->signer.pk;
+    cfg->signer.tokens.token_type = config->signer.tokens.token_type;
+    cfg->internal.clock_rdy = config->internal.clock_rdy;
+    cfg->internal.gmt_offset = config->internal.gmt_offset;
+    unlockToken();
+
+    // renew from the beginning
+    cfg->signer.tokens.expires = 0;
+    cfg->signer.step = gauth_jwt_generation_step_begin;
+
+    refresher->handleToken();
+
+    if (cfg->signer.tokens.status == token_status_ready)
+    {
+        lockToken();
+        // the credentials were changed or reset while renewing
+        bool current = generation == credsGeneration;
+        if (current)
+        {
+            config->internal.auth_token = cfg->internal.auth_token;
+            config->internal.auth_token_generation++;
+            config->signer.tokens.expires = cfg->signer.tokens.expires;
+            config->signer.tokens.last_millis = cfg->signer.tokens.last_millis;
+        }
+        unlockToken();
+        tokenRenewed = current;
+    }
+
+    cfg->internal.auth_token.clear();
+}
+#endif
+
+void GAuthManager::lockToken()
+{
+#if defined(GFORMS_BACKGROUND_TOKEN_REFRESH)
+    if (tokenMutex)
+        xSemaphoreTake(tokenMutex, portMAX_DELAY);
+#endif
+}
+
+void GAuthManager::unlockToken()
+{
+#if defined(GFORMS_BACKGROUND_TOKEN_REFRESH)
+    if (tokenMutex)
+        xSemaphoreGive(tokenMutex);
+#endif
+}
+
+void GAuthManager::credentialsChanged()
+{
+#if defined(GFORMS_BACKGROUND_TOKEN_REFRESH)
+    credsGeneration++;
+    tokenRenewed = false;
+#endif
+}
+
 String GAuthManager::getTokenType(TokenInfo info)
 {
     if (!config)
@@ -1344,9 +1980,12 @@ void GAuthManager::reset()
 {
     if (config)
     {
+        lockToken();
+        credentialsChanged();
         config->internal.client_id.clear();
         config->internal.client_secret.clear();
         config->internal.auth_token.clear();
+        config->internal.auth_token_generation++;
         config->internal.refresh_token.clear();
         config->signer.lastReqMillis = 0;
         config->internal.last_jwt_generation_error_cb_millis = 0;
@@ -1358,6 +1997,15 @@ void GAuthManager::reset()
         config->internal.priv_key_crc = 0;
         config->internal.email_crc = 0;
         config->internal.password_crc = 0;
+        unlockToken();
+
+        freeParsedKey();
+
+        config->internal.cached_token.clear();
+        config->internal.cached_expires = 0;
+        config->internal.cached_crc = 0;
+        if (config->token_cache.file.length() > 0)
+            mbfs->remove(config->token_cache.file, mbfs_type config->token_cache.storage_type);
 
         config->signer.tokens.status = token_status_uninitialized;
     }
@@ -1393,6 +2041,15 @@ unsigned long GAuthManager::getExpiredTimestamp()
     return config->signer.tokens.expires;
 }
 
+unsigned long GAuthManager::serverResponseTimeout()
+{
+    if (config->timeout.serverResponse < GFORMS_MIN_SERVER_RESPONSE_TIMEOUT ||
+        config->timeout.serverResponse > GFORMS_MAX_SERVER_RESPONSE_TIMEOUT)
+        config->timeout.serverResponse = GFORMS_DEFAULT_SERVER_RESPONSE_TIMEOUT;
+
+    return config->timeout.serverResponse;
+}
+
 bool GAuthManager::reconnect(GFORMS_TCP_Client *client, unsigned long dataTime)
 {
     if (!client)
@@ -1402,14 +2059,7 @@ bool GAuthManager::reconnect(GFORMS_TCP_Client *client, unsigned long dataTime)
 
     if (dataTime > 0)
     {
-        unsigned long tmo = GFORMS_DEFAULT_SERVER_RESPONSE_TIMEOUT;
-        if (config->timeout.serverResponse < GFORMS_MIN_SERVER_RESPONSE_TIMEOUT ||
-            config->timeout.serverResponse > GFORMS_MAX_SERVER_RESPONSE_TIMEOUT)
-            config->timeout.serverResponse = GFORMS_DEFAULT_SERVER_RESPONSE_TIMEOUT;
-
-        tmo = config->timeout.serverResponse;
-
-        if (millis() - dataTime > tmo)
+        if (millis() - dataTime > serverResponseTimeout())
         {
             response_code = GFORMS_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT;
             return false;
@@ -1648,6 +2298,9 @@ void GAuthManager::errorToString(int httpCode, MB_String &buff)
     case GFORMS_ERROR_SERVICE_ACCOUNT_JSON_FILE_PARSING_ERROR:
         buff += F("Unable to parse Service Account JSON file. Please check file name, storage type and its content.");
         return;
+    case GFORMS_ERROR_ASYNC_REQUEST_CANCELLED:
+        buff += F("The async request was cancelled.");
+        return;
     default:
         buff += F("unknown error");
         return;
@@ -36,6 +36,15 @@
 #include "MB_NTP.h"
 #include "GForms_Const.h"
 
+struct gforms_pooled_client_t
+{
+    GFORMS_TCP_Client *client = nullptr;
+    // the host that the client is connected to (the external client is shared by all hosts)
+    gforms_pool_host host = gforms_pool_host_forms;
+    unsigned long lastMillis = 0;
+    uint16_t requests = 0;
+};
+
 class GAuthManager
 {
     friend class GFormsClass;
@@ -49,7 +58,9 @@ public:
     ~GAuthManager();
 
 private:
+    /* the client of the connection pool that is being used */
     GFORMS_TCP_Client *tcpClient = nullptr;
+    struct gforms_pooled_client_t pool[gforms_pool_host_max];
     bool localTCPClient = false;
     gauth_cfg_t *config = nullptr;
     MB_FS *mbfs = nullptr;
@@ -63,6 +74,30 @@ private:
 #endif
     TokenInfo tokenInfo;
     bool _token_processing_task_enable = false;
+#if defined(ESP8266) || defined(MB_ARDUINO_PICO)
+    /* the parsed private key kept for the next signing */
+    BearSSL::PrivateKey *parsedKey = nullptr;
+#endif
+    /* the receive buffer kept between the pipelined responses */
+    char *pipeRxBuf = nullptr;
+    int pipeRxPos = 0;
+    int pipeRxEnd = 0;
+    char *pipeChunk = nullptr;
+#if defined(GFORMS_BACKGROUND_TOKEN_REFRESH)
+    /* the background token refresher, it renews the token with its own auth manager, config, file system and SSL client */
+    TaskHandle_t refreshTask = nullptr;
+    SemaphoreHandle_t tokenMutex = nullptr;
+    GAuthManager *refresher = nullptr;
+    gauth_cfg_t *refresherConfig = nullptr;
+    MB_FS *refresherFS = nullptr;
+    volatile bool refreshStop = false;
+    volatile bool tokenRenewed = false;
+    unsigned long lastRenewMillis = 0;
+    /* changed when the credentials were set or reset, the renewed token of old credentials is discarded */
+    uint32_t credsGeneration = 0;
+    /* set under tokenMutex while the token is being renewed by foreground or background, the other side skips the renewal */
+    bool tokenRenewing = false;
+#endif
     FirebaseJson *jsonPtr = nullptr;
     FirebaseJsonData *resultPtr = nullptr;
     int response_code = 0;
@@ -76,8 +111,21 @@ private:
     void end();
     void newClient(GFORMS_TCP_Client **client);
     void freeClient(GFORMS_TCP_Client **client);
+    /* select the pooled client of the host as tcpClient, the idle connections are closed */
+    GFORMS_TCP_Client *useClient(gforms_pool_host host, bool newRequest = false);
+    /* start the idle time of the pooled connection */
+    void idleClient(GFORMS_TCP_Client *client);
+    void closeIdleClients();
     /* parse service account json file for private key */
     bool parseSAFile();
+#if defined(ESP8266) || defined(MB_ARDUINO_PICO)
+    /* get the RSA PKCS1 signing engine selected by GFORMS_RSA_SIGN_ENGINE */
+    br_rsa_pkcs1_sign getRSASigner();
+#endif
+    /* check for the parsed private key was kept */
+    bool parsedKeyReady();
+    /* free the kept parsed private key */
+    void freeParsedKey();
     /* clear service account credentials */
     void clearServiceAccountCreds();
     /* check for sevice account credentials */
@@ -110,19 +158,59 @@ private:
     bool handleTaskError(int code, int httpCode = 0);
     /* parse key/value */
     MB_String getValue(MB_String &response, const char *key);
-    /* parse the auth token response */
-    bool handleResponse(GFORMS_TCP_Client *client, int &httpCode, MB_String &payload, const char *key = "", bool stopSession = true);
+    /* parse the auth token response, or feed the payload to the JSON stream parser when stream was set */
+    bool handleResponse(GFORMS_TCP_Client *client, int &httpCode, MB_String &payload, const char *key = "", bool stopSession = true,
+                        gforms_json_stream_state_t *stream = nullptr);
+    /* prepare the reader for the response that can be read in several calls of readResponse */
+    bool beginResponse(GFORMS_TCP_Client *client, struct gforms_response_reader_t &reader, const char *key,
+                       gforms_json_stream_state_t *stream);
+    /* read the available response data (up to maxReads chunks, 0 for until complete),
+    returns 1 when complete, 0 when more data is required and -1 for error */
+    int readResponse(GFORMS_TCP_Client *client, struct gforms_response_reader_t &reader, MB_String &payload, int maxReads = 0);
+    /* finish the response reading and returns the status as handleResponse */
+    bool completeResponse(GFORMS_TCP_Client *client, struct gforms_response_reader_t &reader, int &httpCode,
+                          MB_String &payload, bool stopSession);
+    void freeResponse(struct gforms_response_reader_t &reader);
+    /* handle the token request response, its JSON payload is parsed in place */
+    bool handleTokenResponse(int &httpCode, MB_String &payload);
+    /* free or keep (pipelined) the receive buffer of response handler */
+    void endResponse(struct gforms_tcp_response_handler_t &tcpHandler);
+    /* keep the receive and chunk buffers between the pipelined responses */
+    void beginPipeline();
+    void endPipeline();
     /* process the tokens (generation, signing, request and refresh) */
     void tokenProcessingTask();
     bool checkUDP(UDP *udp, bool &ret, bool &_token_processing_task_enable, float gmtOffset);
     /* encode and sign the JWT token */
     bool createJWT();
+    /* encode the JWT header and the claims that are constant for the service account */
+    void createJWTPrefix();
+    /* start or stop the background token refresher */
+    void setBackgroundRefresh(bool enable);
+#if defined(GFORMS_BACKGROUND_TOKEN_REFRESH)
+    static void refreshTaskFunc(void *param);
+    /* renew the token with the refresher and swap it into the current config */
+    void renewToken();
+#endif
+    /* lock the access token while it is being read or swapped */
+    void lockToken();
+    void unlockToken();
+    /* discard the token that is being renewed in background, called with the token locked */
+    void credentialsChanged();
     /* request or refresh the token */
     bool requestTokens(bool refresh);
     /* check the token ready status and process the token tasks */
     void checkToken();
     /* parse expiry time from string */
     void getExpiration(const char *exp);
+    /* the crc of the parsed service account identity (client email, private key id and project id) */
+    uint16_t getIdentityCRC();
+    /* read the access token from token cache file if it belongs to current service account */
+    bool readTokenCache();
+    /* save the access token and its expiry time to token cache file */
+    void writeTokenCache();
+    /* use the cached access token if it is not expired */
+    bool useTokenCache();
     /* return error string from code */
     void errorToString(int httpCode, MB_String &buff);
     /* check the token ready status and process the token tasks and returns the status */
@@ -149,6 +237,8 @@ private:
     String getTokenError();
     unsigned long getExpiredTimestamp();
     bool reconnect(GFORMS_TCP_Client *client, unsigned long dataTime = 0);
+    /* the configured server response timeout, the default is used when it is out of range */
+    unsigned long serverResponseTimeout();
     bool reconnect();
 
 #if defined(ESP8266)
@@ -41,6 +41,65 @@
 
 #include "FirebaseJson.h"
 
+// FNV-1a, shared by the compiled path keys and the object key index
+static uint32_t fbjs_hash(const char *s)
+{
+    uint32_t h = 2166136261UL;
+    while (*s)
+    {
+        h ^= (uint8_t)*s++;
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+// whether MB_JSON would escape the string when printing it
+static bool fbjs_need_escape(const char *s)
+{
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\' || (uint8_t)*s < 32)
+            return true;
+    }
+    return false;
+}
+
+void FirebaseJsonPath::setPath(const char *path)
+{
+    keys.clear();
+    indexes.clear();
+    hashes.clear();
+
+    MB_String str = path;
+    size_t previous = 0, current = 0;
+    while (previous <= str.length())
+    {
+        current = str.find('/', previous);
+        if (current == MB_String::npos)
+            current = str.length();
+
+        MB_String key = str.substr(previous, current - previous);
+        key.trim();
+        previous = current + 1;
+
+        if (key.length() == 0)
+            continue;
+
+        int index = -1;
+        if (key[0] == '[' && key[key.length() - 1] == ']')
+        {
+            index = atoi(key.substr(1, key.length() - 2).c_str());
+            if (index < 0)
+                index = 0;
+        }
+
+        uint32_t hash = fbjs_hash(key.c_str());
+        keys.push_back(key);
+        indexes.push_back(index);
+        hashes.push_back(hash);
+    }
+}
+
 FirebaseJsonBase::FirebaseJsonBase()
 {
     MB_JSON_InitHooks(&MB_JSON_hooks);
@@ -49,14 +108,19 @@ FirebaseJsonBase::FirebaseJsonBase()
 FirebaseJsonBase::~FirebaseJsonBase()
 {
     mClear();
+    MB_JSON_StreamDestroy(readParser);
+    MB_JSON_ArenaDestroy(arena);
 }
 
 FirebaseJsonBase &FirebaseJsonBase::mClear()
 {
     mIteratorEnd();
+    clearKeyIndex();
     if (root != NULL)
         MB_JSON_Delete(root);
     root = NULL;
+    MB_JSON_ArenaReset(arena);
+    inSituBuf.clear();
     buf.clear();
     errorPos = -1;
     return *this;
@@ -77,7 +141,19 @@ void FirebaseJsonBase::mCopy(FirebaseJsonBase &other)
 bool FirebaseJsonBase::setRaw(const char *raw)
 {
     mClear();
+    return mSetRoot(raw, false);
+}
 
+bool FirebaseJsonBase::mSetRawInSitu(MB_String &raw)
+{
+    mClear();
+    // take the buffer over, the parsed keys and strings point into it
+    inSituBuf.move(raw);
+    return mSetRoot(inSituBuf.c_str(), true);
+}
+
+bool FirebaseJsonBase::mSetRoot(const char *raw, bool inSitu)
+{
     if (raw)
     {
         size_t i = 0;
@@ -89,23 +165,39 @@ bool FirebaseJsonBase::setRaw(const char *raw)
         if (raw[i] == '{' || raw[i] == '[')
         {
             this->root_type = (raw[i] == '{') ? Root_Type_JSON : Root_Type_JSONArray;
-            root = parse(raw);
+            root = parse(raw, inSitu);
         }
         else
         {
             this->root_type = Root_Type_Raw;
             root = MB_JSON_CreateRaw(raw);
+            // the raw item has its own copy
+            inSituBuf.clear();
         }
     }
 
     return root != NULL;
 }
 
-MB_JSON *FirebaseJsonBase::parse(const char *raw)
+MB_JSON *FirebaseJsonBase::parse(const char *raw, bool inSitu)
 {
     const char *s = NULL;
-    MB_JSON *e = MB_JSON_ParseWithOpts(raw, &s, 1);
-    errorPos = (s - raw != (int)strlen(raw)) ? s - raw : -1;
+    MB_JSON *e = NULL;
+    // the in-situ parse cuts the raw string
+    int len = strlen(raw);
+    clearKeyIndex();
+    // the previous root was already deleted by the caller
+    if (!inSitu)
+        inSituBuf.clear();
+    if (arena)
+        MB_JSON_ArenaReset(arena);
+    if (inSitu)
+        e = MB_JSON_ParseInSitu((char *)raw, &s, 1, arena);
+    else if (arena)
+        e = MB_JSON_ParseWithArena(raw, &s, 1, arena);
+    else
+        e = MB_JSON_ParseWithOpts(raw, &s, 1);
+    errorPos = (s - raw != len) ? s - raw : -1;
     return e;
 }
 
@@ -345,18 +437,45 @@ void FirebaseJsonBase::replace(MB_VECTOR<MB_String> &keys, struct search_result_
 size_t FirebaseJsonBase::mIteratorBegin(MB_JSON *parent)
 {
     mIteratorEnd();
-    char *p = MB_JSON_PrintUnformatted(parent);
+    char *p = MB_JSON_PrintTraced(parent, mTraceIterator, &iterator_data);
     if (p == NULL)
+    {
+        mIteratorEnd();
         return 0;
+    }
 
     buf = p;
     MB_JSON_free(p);
     iterator_data.buf_size = buf.length();
     int index = -1;
     mIterate(parent, index);
+
+    iterator_data.trace.clear();
+    iterator_data.traceOpen.clear();
+    iterator_data.tracePos = 0;
     return iterator_data.result.size();
 }
 
+void FirebaseJsonBase::mTraceIterator(const MB_JSON *item, size_t key, size_t start, size_t end, void *arg)
+{
+    struct iterator_data_t *data = (struct iterator_data_t *)arg;
+    if (end == 0)
+    {
+        struct iterator_trace_t t;
+        t.item = (MB_JSON *)item;
+        t.key = key;
+        t.start = start;
+        size_t index = data->trace.size();
+        data->trace.push_back(t);
+        data->traceOpen.push_back(index);
+    }
+    else if (data->traceOpen.size() > 0)
+    {
+        data->trace[data->traceOpen[data->traceOpen.size() - 1]].end = end;
+        data->traceOpen.pop_back();
+    }
+}
+
 size_t FirebaseJsonBase::mIteratorBegin(MB_JSON *parent, MB_VECTOR<MB_String> *keys)
 {
     mIteratorEnd();
@@ -376,10 +495,12 @@ void FirebaseJsonBase::mIteratorEnd(bool clearBuf)
         buf.clear();
     iterator_data.path.clear();
     iterator_data.buf_size = 0;
-    iterator_data.buf_offset = 0;
     iterator_data.result.clear();
     iterator_data.depth = -1;
     iterator_data._depth = 0;
+    iterator_data.trace.clear();
+    iterator_data.traceOpen.clear();
+    iterator_data.tracePos = 0;
     if (iterator_data.parentArr != NULL)
         MB_JSON_Delete(iterator_data.parentArr);
     iterator_data.parentArr = NULL;
@@ -442,30 +563,27 @@ void FirebaseJsonBase::mCollectIterator(MB_JSON *e, int type, int &arrIndex)
 {
     struct iterator_result_t result;
 
-    if (e->string)
-    {
-        size_t pos = buf.find((const char *)e->string, iterator_data.buf_offset);
-        if (pos != MB_String::npos)
-        {
-            result.ofs1 = pos;
-            result.len1 = strlen(e->string);
-            iterator_data.buf_offset = (e->type != MB_JSON_Object && e->type != MB_JSON_Array) ? pos + result.len1 : pos;
-        }
-    }
+    // the items were traced in document order while printing and are collected in the same order
+    size_t pos = iterator_data.tracePos;
+    while (pos < iterator_data.trace.size() && iterator_data.trace[pos].item != e)
+        pos++;
 
-    char *p = MB_JSON_PrintUnformatted(e);
-    if (p)
+    if (pos < iterator_data.trace.size())
     {
-        int i = iterator_data.buf_offset;
-        size_t pos = buf.find(p, i);
-        if (pos != MB_String::npos)
+        struct iterator_trace_t &t = iterator_data.trace[pos];
+        if (t.key < t.start)
         {
-            result.ofs2 = pos - result.ofs1 - result.len1;
-            result.len2 = strlen(p);
-            MB_JSON_free(p);
-            iterator_data.buf_offset = (e->type != MB_JSON_Object && e->type != MB_JSON_Array) ? pos + result.len2 : pos;
+            // "key":value
+            result.ofs1 = t.key + 1;
+            result.len1 = t.start - t.key - 3;
+            result.ofs2 = 2;
         }
+        else
+            result.ofs1 = t.start;
+        result.len2 = t.end - t.start;
+        iterator_data.tracePos = pos + 1;
     }
+
     result.type = type;
     result.depth = iterator_data.depth;
     iterator_data.result.push_back(result);
@@ -530,58 +648,61 @@ struct FirebaseJsonBase::fb_js_iterator_value_t FirebaseJsonBase::mValueAt(size_
 void FirebaseJsonBase::toBuf(fb_json_serialize_mode mode)
 {
     if (root != NULL)
-    {
-        char *out = mode == fb_json_serialize_mode_pretty ? MB_JSON_Print(root) : MB_JSON_PrintUnformatted(root);
-        if (out)
-        {
-            buf = out;
-            MB_JSON_free(out);
-        }
-    }
+        mPrintTo(buf, mode == fb_json_serialize_mode_pretty);
+}
+
+bool FirebaseJsonBase::mPrintTo(MB_String &out, bool prettify)
+{
+    // size the string with the length pass and print straight into it
+    size_t len = MB_JSON_SerializedBufferLength(root, prettify) + FBJS_PRINT_SLACK;
+    out.clear();
+    out.reserve(len);
+    if (out.bufferLength() > len && MB_JSON_PrintPreallocated(root, &out[0], len + 1, prettify))
+        return true;
+
+    char *p = prettify ? MB_JSON_Print(root) : MB_JSON_PrintUnformatted(root);
+    out = p ? p : "";
+    MB_JSON_free(p);
+    return p != NULL;
+}
+
+bool FirebaseJsonBase::mBeginRead()
+{
+    if (!readParser)
+        readParser = MB_JSON_StreamCreate(0, FBJS_READ_MAX_SIZE);
+    return readParser != NULL;
+}
+
+bool FirebaseJsonBase::mEndRead()
+{
+    MB_JSON *e = MB_JSON_StreamTake(readParser);
+    if (e == NULL)
+        return false;
+    mClear();
+    root = e;
+    return true;
 }
 
 bool FirebaseJsonBase::mReadClient(Client *client)
 {
-    // blocking read
-    buf.clear();
-    if (readClient(client, buf))
-    {
-        if (root != NULL)
-            MB_JSON_Delete(root);
-        root = parse(buf.c_str());
-        buf.clear();
-        return root != NULL;
-    }
-    return false;
+    // blocking read, the payload is parsed as it arrives
+    if (!mBeginRead())
+        return false;
+    MB_JSON_StreamReset(readParser);
+    return readClient(client, readParser) && mEndRead();
 }
 
 bool FirebaseJsonBase::mReadStream(Stream *s, int timeoutMS)
 {
-    // non-blocking read
-    if (readStream(s, serData, buf, true, timeoutMS))
-    {
-        if (root != NULL)
-            MB_JSON_Delete(root);
-        root = parse(buf.c_str());
-        buf.clear();
-        return root != NULL;
-    }
-    return false;
+    // non-blocking read, the data is parsed as it arrives
+    return mBeginRead() && readStream(s, serData, timeoutMS) && mEndRead();
 }
 
 #if defined(ESP32_SD_FAT_INCLUDED)
 bool FirebaseJsonBase::mReadSdFat(SD_FAT_FILE &file, int timeoutMS)
 {
-    // non-blocking read
-    if (readSdFatFile(file, serData, buf, true, timeoutMS))
-    {
-        if (root != NULL)
-            MB_JSON_Delete(root);
-        root = parse(buf.c_str());
-        buf.clear();
-        return root != NULL;
-    }
-    return false;
+    // non-blocking read, the data is parsed as it arrives
+    return mBeginRead() && readSdFatFile(file, serData, timeoutMS) && mEndRead();
 }
 #endif
 
@@ -595,6 +716,7 @@ bool FirebaseJsonBase::mRemove(const char *path)
 {
     bool ret = false;
     prepareRoot();
+    clearKeyIndex();
     MB_VECTOR<MB_String> keys = MB_VECTOR<MB_String>();
     makeList(path, keys, '/');
 
@@ -666,6 +788,14 @@ void FirebaseJsonBase::mSetDoubleDigits(uint8_t digits)
     doubleDigits = digits;
 }
 
+void FirebaseJsonBase::mUseArena(size_t blockSize)
+{
+    // the current tree may live in the arena
+    mClear();
+    MB_JSON_ArenaDestroy(arena);
+    arena = blockSize > 0 ? MB_JSON_ArenaCreate(blockSize) : NULL;
+}
+
 int FirebaseJsonBase::mResponseCode()
 {
     return httpCode;
@@ -673,51 +803,169 @@ int FirebaseJsonBase::mResponseCode()
 
 bool FirebaseJsonBase::mGet(MB_JSON *parent, FirebaseJsonData *result, const char *path, bool prettify)
 {
-    bool ret = false;
+    FirebaseJsonPath p(path);
+    return mGet(parent, result, p, prettify);
+}
+
+bool FirebaseJsonBase::mGet(MB_JSON *parent, FirebaseJsonData *result, const FirebaseJsonPath &path, bool prettify)
+{
     prepareRoot();
-    MB_VECTOR<MB_String> keys = MB_VECTOR<MB_String>();
-    makeList(path, keys, '/');
 
-    if (keys.size() > 0)
+    const FirebaseJsonPath &p = path;
+
+    if (p.size() == 0 || (p.indexes[0] > -1 && root_type == Root_Type_JSON))
+        return false;
+
+    MB_JSON *data = parent;
+    for (size_t i = 0; i < p.size() && data != NULL; i++)
     {
-        if (isArrayKey(keys[0].c_str()) && root_type == Root_Type_JSON)
+        if (p.indexes[i] > -1)
+            data = isArray(data) ? MB_JSON_GetArrayItem(data, p.indexes[i]) : NULL;
+        else
+            data = isObject(data) ? getObjectItem(data, p.keys[i].c_str(), p.hashes[i]) : NULL;
+    }
+
+    if (data == NULL)
+        return false;
+
+    if (result != NULL)
+        mSetResult(result, data, prettify);
+
+    return true;
+}
+
+void FirebaseJsonBase::mSetResult(FirebaseJsonData *result, MB_JSON *data, bool prettify)
+{
+    result->clear();
+    result->type_num = data->type;
+    result->success = true;
+
+    // scalars are taken from the node, only objects, arrays and strings that need escaping are printed
+    bool printed = false;
+    switch (data->type & 0xFF)
+    {
+    case MB_JSON_String:
+        if (!data->valuestring || !fbjs_need_escape(data->valuestring))
         {
-            clearList(keys);
-            return false;
+            result->stringValue = data->valuestring ? data->valuestring : "";
+            printed = true;
+        }
+        break;
+
+    case MB_JSON_Raw:
+        if (data->valuestring)
+        {
+            result->stringValue = data->valuestring;
+            printed = true;
+        }
+        break;
+
+    case MB_JSON_Number:
+    {
+        char num[32];
+        if (MB_JSON_PrintPreallocated(data, num, sizeof(num), false))
+        {
+            result->stringValue = num;
+            printed = true;
         }
+        break;
     }
 
-    MB_JSON *_parent = parent;
-    struct search_result_t r;
-    searchElements(keys, parent, r);
-    _parent = r.parent;
+    case MB_JSON_True:
+    case MB_JSON_False:
+    case MB_JSON_NULL:
+        result->stringValue = (data->type & 0xFF) == MB_JSON_True ? "true" : (data->type & 0xFF) == MB_JSON_False ? "false" : "null";
+        printed = true;
+        break;
 
-    if (r.status == key_status_existed)
+    default:
+        break;
+    }
+
+    if (!printed)
     {
-        MB_JSON *data = NULL;
-        if (isArray(_parent))
-            data = MB_JSON_GetArrayItem(_parent, getArrIndex(keys[r.stopIndex].c_str()));
-        else
-            data = MB_JSON_GetObjectItemCaseSensitive(_parent, keys[r.stopIndex].c_str());
+        char *p = prettify ? MB_JSON_Print(data) : MB_JSON_PrintUnformatted(data);
+        result->stringValue = p;
+        MB_JSON_free(p);
+    }
 
-        if (data != NULL)
+    mSetElementType(result, data);
+}
+
+MB_JSON *FirebaseJsonBase::getObjectItem(MB_JSON *object, const char *key, uint32_t hash)
+{
+#if defined(MB_USE_STD_VECTOR)
+    if (FBJS_KEY_INDEX_MIN_SIZE > 0 && FBJS_KEY_INDEX_CACHE_SIZE > 0)
+    {
+        // the most recently used index is kept first
+        size_t found = keyIndexes.size();
+        for (size_t i = 0; i < keyIndexes.size() && found == keyIndexes.size(); i++)
         {
-            if (result != NULL)
+            if (keyIndexes[i].object == object)
+                found = i;
+        }
+
+        if (found == keyIndexes.size())
+        {
+            size_t count = 0;
+            for (MB_JSON *e = object->child; e && count < FBJS_KEY_INDEX_MIN_SIZE; e = e->next)
+                count++;
+
+            if (count < FBJS_KEY_INDEX_MIN_SIZE)
+                return MB_JSON_GetObjectItemCaseSensitive(object, key);
+
+            count = 0;
+            for (MB_JSON *e = object->child; e; e = e->next)
+                count++;
+
+            // at most half full so the probing stays short and always ends
+            size_t size = 1;
+            while (size < count * 2)
+                size <<= 1;
+
+            // reuse the least recently used index when the cache is full
+            if (keyIndexes.size() < FBJS_KEY_INDEX_CACHE_SIZE)
+                keyIndexes.push_back(key_index_t());
+            found = keyIndexes.size() - 1;
+
+            key_index_t *index = &keyIndexes[found];
+            index->object = object;
+            index->slots.assign(size, NULL);
+
+            // keep the first of the duplicate keys as MB_JSON_GetObjectItemCaseSensitive does
+            for (MB_JSON *e = object->child; e; e = e->next)
             {
-                result->clear();
-                char *p = prettify ? MB_JSON_Print(data) : MB_JSON_PrintUnformatted(data);
-                result->stringValue = p;
-                MB_JSON_free(p);
-                result->type_num = data->type;
-                result->success = true;
-                mSetElementType(result);
+                if (!e->string)
+                    continue;
+                size_t s = fbjs_hash(e->string) & (size - 1);
+                while (index->slots[s] && strcmp(index->slots[s]->string, e->string) != 0)
+                    s = (s + 1) & (size - 1);
+                if (!index->slots[s])
+                    index->slots[s] = e;
             }
-            ret = true;
         }
+
+        for (; found > 0; found--)
+            std::swap(keyIndexes[found], keyIndexes[found - 1]);
+
+        key_index_t *index = &keyIndexes[0];
+        size_t mask = index->slots.size() - 1;
+        for (size_t s = hash & mask; index->slots[s]; s = (s + 1) & mask)
+        {
+            if (strcmp(index->slots[s]->string, key) == 0)
+                return index->slots[s];
+        }
+        return NULL;
     }
+#endif
+    return MB_JSON_GetObjectItemCaseSensitive(object, key);
+}
 
-    clearList(keys);
-    return ret;
+void FirebaseJsonBase::clearKeyIndex()
+{
+#if defined(MB_USE_STD_VECTOR)
+    keyIndexes.clear();
+#endif
 }
 
 void FirebaseJsonBase::mSetResInt(FirebaseJsonData *data, const char *value)
@@ -752,7 +1000,7 @@ void FirebaseJsonBase::mSetResFloat(FirebaseJsonData *data, const char *value)
     data->floatValue = data->fVal.f;
 }
 
-void FirebaseJsonBase::mSetElementType(FirebaseJsonData *result)
+void FirebaseJsonBase::mSetElementType(FirebaseJsonData *result, MB_JSON *data)
 {
     char *buf = (char *)newP(32);
     if (result->type_num == MB_JSON_Invalid)
@@ -772,10 +1020,13 @@ void FirebaseJsonBase::mSetElementType(FirebaseJsonData *result)
     }
     else if (result->type_num == MB_JSON_String)
     {
-        if (result->stringValue.c_str()[0] == '"')
+        // printed strings come quoted, the ones taken from the node do not
+        size_t len = result->stringValue.length();
+        if (len > 1 && result->stringValue.c_str()[0] == '"' && result->stringValue.c_str()[len - 1] == '"')
+        {
+            result->stringValue.remove(len - 1, 1);
             result->stringValue.remove(0, 1);
-        if (result->stringValue.c_str()[result->stringValue.length() - 1] == '"')
-            result->stringValue.remove(result->stringValue.length() - 1, 1);
+        }
 
         strcpy(buf, (const char *)MBSTRING_FLASH_MCR("string"));
         result->typeNum = JSON_STRING;
@@ -808,7 +1059,14 @@ void FirebaseJsonBase::mSetElementType(FirebaseJsonData *result)
     else if (result->type_num == MB_JSON_Number || result->type_num == MB_JSON_Raw)
     {
         mSetResInt(result, result->stringValue.c_str());
-        mSetResFloat(result, result->stringValue.c_str());
+        if (data && (data->type & 0xFF) == MB_JSON_Number)
+        {
+            result->fVal.setd(data->valuedouble);
+            result->doubleValue = result->fVal.d;
+            result->floatValue = result->fVal.f;
+        }
+        else
+            mSetResFloat(result, result->stringValue.c_str());
 
         if (strpos(result->stringValue.c_str(), (const char *)MBSTRING_FLASH_MCR("."), 0) > -1)
         {
@@ -838,6 +1096,7 @@ void FirebaseJsonBase::mSetElementType(FirebaseJsonData *result)
 void FirebaseJsonBase::mSet(const char *path, MB_JSON *value)
 {
     prepareRoot();
+    clearKeyIndex();
     MB_VECTOR<MB_String> keys = MB_VECTOR<MB_String>();
     makeList(path, keys, '/');
 
@@ -904,6 +1163,7 @@ FirebaseJson::~FirebaseJson()
 FirebaseJson &FirebaseJson::nAdd(const char *key, MB_JSON *value)
 {
     prepareRoot();
+    clearKeyIndex();
     MB_VECTOR<MB_String> keys = MB_VECTOR<MB_String>();
     // makeList(key, keys, '/');
     MB_String ky = key;
@@ -949,6 +1209,7 @@ FirebaseJsonArray::FirebaseJsonArray(FirebaseJsonArray &other)
 
 FirebaseJsonArray &FirebaseJsonArray::nAdd(MB_JSON *value)
 {
+    clearKeyIndex();
     if (root_type != Root_Type_JSONArray)
         mClear();
 
@@ -977,12 +1238,7 @@ bool FirebaseJsonArray::mGetIdx(FirebaseJsonData *result, int index, bool pretti
 
     if (data != NULL)
     {
-        char *p = prettify ? MB_JSON_Print(data) : MB_JSON_PrintUnformatted(data);
-        result->stringValue = p;
-        MB_JSON_free(p);
-        result->type_num = data->type;
-        result->success = true;
-        mSetElementType(result);
+        mSetResult(result, data, prettify);
         ret = true;
     }
     return ret;
@@ -990,6 +1246,7 @@ bool FirebaseJsonArray::mGetIdx(FirebaseJsonData *result, int index, bool pretti
 
 bool FirebaseJsonArray::mSetIdx(int index, MB_JSON *value)
 {
+    clearKeyIndex();
     if (root_type != Root_Type_JSONArray)
         mClear();
 
@@ -1014,6 +1271,7 @@ bool FirebaseJsonArray::mSetIdx(int index, MB_JSON *value)
 
 bool FirebaseJsonArray::mRemoveIdx(int index)
 {
+    clearKeyIndex();
     int size = MB_JSON_GetArraySize(root);
     if (index < size)
     {
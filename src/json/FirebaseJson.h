@@ -177,6 +177,34 @@ fb_json_putchar(char c)
 
 #endif
 
+/// The buffer size for writing the serialized JSON to Stream and File in pieces
+#ifndef FBJS_STREAM_CHUNK_SIZE
+#define FBJS_STREAM_CHUNK_SIZE 512
+#endif
+
+/// The printer reserves a few bytes ahead of what it writes, added to the exact length when printing in place
+#define FBJS_PRINT_SLACK 4
+
+/// The maximum size in bytes of a JSON read from Stream, Client or file, 0 for no limit
+#ifndef FBJS_READ_MAX_SIZE
+#define FBJS_READ_MAX_SIZE 0
+#endif
+
+/// The default block size of the arena that holds the parsed JSON tree, see useArena
+#ifndef FBJS_ARENA_BLOCK_SIZE
+#define FBJS_ARENA_BLOCK_SIZE 1024
+#endif
+
+/// Objects with at least this many members get a hashed key index on first get, 0 to always scan linearly
+#ifndef FBJS_KEY_INDEX_MIN_SIZE
+#define FBJS_KEY_INDEX_MIN_SIZE 16
+#endif
+
+/// The number of objects whose key index is kept, the least recently used index is rebuilt for the other object
+#ifndef FBJS_KEY_INDEX_CACHE_SIZE
+#define FBJS_KEY_INDEX_CACHE_SIZE 2
+#endif
+
 /// HTTP codes see RFC7231
 #define FBJS_ERROR_HTTP_CODE_OK 200
 #define FBJS_ERROR_HTTP_CODE_NON_AUTHORITATIVE_INFORMATION 203
@@ -306,9 +334,8 @@ namespace fb_js
 
     struct serial_data_t
     {
-        int pos = -1, start = -1, end = -1;
-        int scnt = 0, ecnt = 0;
-        MB_String buf;
+        // the bytes fed to the stream parser, -1 before the JSON begins
+        int pos = -1;
         unsigned long dataTime = 0;
     };
 };
@@ -549,6 +576,35 @@ private:
     }
 };
 
+class FirebaseJsonPath
+{
+    friend class FirebaseJsonBase;
+
+public:
+    FirebaseJsonPath() {}
+    FirebaseJsonPath(const char *path) { setPath(path); }
+    FirebaseJsonPath(const String &path) { setPath(path.c_str()); }
+
+    /**
+     * Split the path into keys once so it can be used for any number of get calls.
+     *
+     * @param path The relative path e.g. responses/[0]/answers.
+     */
+    void setPath(const char *path);
+
+    /**
+     * Get the number of keys in the path.
+     * @return number of keys.
+     */
+    size_t size() const { return keys.size(); }
+
+private:
+    MB_VECTOR<MB_String> keys;
+    // the array index of [n] keys, -1 for object keys
+    MB_VECTOR<int> indexes;
+    MB_VECTOR<uint32_t> hashes;
+};
+
 class FirebaseJsonBase
 {
     friend class FirebaseJson;
@@ -579,26 +635,46 @@ private:
         int stopIndex = 0;
     };
 
+#if defined(MB_USE_STD_VECTOR)
+    struct key_index_t
+    {
+        MB_JSON *object = NULL;
+        // open addressing table of the object members, the size is a power of two
+        MB_VECTOR<MB_JSON *> slots;
+    };
+#endif
+
     struct iterator_result_t
     {
-        uint16_t ofs1 = 0;
-        uint8_t len1 = 0;
+        uint32_t ofs1 = 0;
+        uint32_t len2 = 0;
+        uint16_t len1 = 0;
         uint8_t ofs2 = 0;
-        uint16_t len2 = 0;
         uint8_t type = 0;
         int16_t depth = -1;
     };
 
+    // where an item was printed in the iterator buffer
+    struct iterator_trace_t
+    {
+        MB_JSON *item = NULL;
+        uint32_t key = 0;
+        uint32_t start = 0;
+        uint32_t end = 0;
+    };
+
     struct iterator_data_t
     {
         MB_VECTOR<struct iterator_result_t> result;
-        int buf_offset = 0;
         size_t buf_size = 0;
         int depth = -1;
         int _depth = 0;
         MB_JSON *parent = NULL;
         MB_JSON *parentArr = NULL;
         MB_String path;
+        MB_VECTOR<struct iterator_trace_t> trace;
+        MB_VECTOR<size_t> traceOpen;
+        size_t tracePos = 0;
     };
 
     struct fb_js_iterator_value_t
@@ -612,8 +688,10 @@ private:
     FirebaseJsonBase &mClear();
     void mIteratorEnd(bool clearBuf = true);
     bool setRaw(const char *raw);
+    bool mSetRawInSitu(MB_String &raw);
+    bool mSetRoot(const char *raw, bool inSitu);
     void prepareRoot();
-    MB_JSON *parse(const char *raw);
+    MB_JSON *parse(const char *raw, bool inSitu = false);
     void searchElements(MB_VECTOR<MB_String> &keys, MB_JSON *parent, struct search_result_t &r);
     MB_JSON *getElement(MB_JSON *parent, const char *key, struct search_result_t &r);
     void mAdd(MB_VECTOR<MB_String> keys, MB_JSON **parent, int beginIndex, MB_JSON *value);
@@ -629,10 +707,14 @@ private:
     size_t mIteratorBegin(MB_JSON *parent);
     size_t mIteratorBegin(MB_JSON *parent, MB_VECTOR<MB_String> *keys);
     void mCollectIterator(MB_JSON *e, int type, int &arrIndex);
+    static void mTraceIterator(const MB_JSON *item, size_t key, size_t start, size_t end, void *arg);
     void mIterate(MB_JSON *parent, int &arrIndex);
     int mIteratorGet(size_t index, int &type, String &key, String &value);
     struct fb_js_iterator_value_t mValueAt(size_t index);
     void toBuf(fb_json_serialize_mode mode);
+    bool mPrintTo(MB_String &out, bool prettify);
+    bool mBeginRead();
+    bool mEndRead();
     bool mReadClient(Client *client);
     bool mReadStream(Stream *s, int timeoutMS);
 #if defined(ESP32_SD_FAT_INCLUDED)
@@ -643,12 +725,17 @@ private:
     void mGetPath(MB_String &path, MB_VECTOR<MB_String> paths, int begin = 0, int end = -1);
     size_t mGetSerializedBufferLength(bool prettify);
     void mSetFloatDigits(uint8_t digits);
+    void mUseArena(size_t blockSize);
     void mSetDoubleDigits(uint8_t digits);
     int mResponseCode();
     bool mGet(MB_JSON *parent, FirebaseJsonData *result, const char *path, bool prettify = false);
+    bool mGet(MB_JSON *parent, FirebaseJsonData *result, const FirebaseJsonPath &path, bool prettify = false);
+    MB_JSON *getObjectItem(MB_JSON *object, const char *key, uint32_t hash);
+    void clearKeyIndex();
     void mSetResInt(FirebaseJsonData *data, const char *value);
     void mSetResFloat(FirebaseJsonData *data, const char *value);
-    void mSetElementType(FirebaseJsonData *result);
+    void mSetElementType(FirebaseJsonData *result, MB_JSON *data = NULL);
+    void mSetResult(FirebaseJsonData *result, MB_JSON *data, bool prettify);
     void mSet(const char *path, MB_JSON *value);
     void mCopy(FirebaseJsonBase &other);
 #if defined(__AVR__)
@@ -698,7 +785,15 @@ protected:
     fb_json_root_type root_type = Root_Type_JSON;
     struct iterator_data_t iterator_data;
     MB_JSON *root = NULL;
+    MB_JSON_Arena *arena = NULL;
+    // parses the JSON from Stream, Client and file while reading
+    MB_JSON_Stream *readParser = NULL;
+    // the parsed response that the tree of setJsonDataInSitu points into
+    MB_String inSituBuf;
     MB_JSON_Hooks *hooks = NULL;
+#if defined(MB_USE_STD_VECTOR)
+    MB_VECTOR<key_index_t> keyIndexes;
+#endif
     MB_String buf;
 
     template <typename T>
@@ -755,17 +850,20 @@ protected:
 
         if (MB_IS_SAME<T, char>::value)
         {
-            char *p = prettify ? MB_JSON_Print(root) : MB_JSON_PrintUnformatted(root);
-            if (p)
-            {
-                strcpy(ptr, p);
-                MB_JSON_free(p);
-                return true;
-            }
+            // only the printed text and its terminator are written, as with the previous strcpy
+            size_t len = MB_JSON_SerializedBufferLength(root, prettify) + FBJS_PRINT_SLACK;
+            return MB_JSON_PrintPreallocated(root, (char *)ptr, len + 1, prettify);
         }
         return false;
     }
 
+    bool toStringHandler(MB_String &out, bool prettify)
+    {
+        if (!root)
+            return false;
+        return mPrintTo(out, prettify);
+    }
+
     template <typename T>
     auto toStringHandler(T &out, bool prettify) -> typename MB_ENABLE_IF<is_string<T>::value, bool>::type
     {
@@ -818,22 +916,20 @@ protected:
 #endif
 
     template <typename T>
-    bool writeStream(T &out, bool prettify)
+    static MB_JSON_bool writeChunk(const unsigned char *data, size_t len, void *arg)
     {
-        bool ret = false;
+        T *out = reinterpret_cast<T *>(arg);
+        return out->write((const uint8_t *)data, len) == len;
+    }
 
+    template <typename T>
+    bool writeStream(T &out, bool prettify)
+    {
         if (!root)
             return false;
 
-        char *p = prettify ? MB_JSON_Print(root) : MB_JSON_PrintUnformatted(root);
-        if (p)
-        {
-            ret = out.write((const uint8_t *)p, strlen(p)) == strlen(p);
-            MB_JSON_free(p);
-            return ret;
-        }
-
-        return ret;
+        // serialize in pieces, the whole JSON string is not held in memory
+        return MB_JSON_PrintChunked(root, FBJS_STREAM_CHUNK_SIZE, prettify, writeChunk<T>, &out);
     }
 
     void idle()
@@ -1329,7 +1425,7 @@ protected:
         return olen;
     }
 
-    int readClient(Client *client, MB_String &buf)
+    int readClient(Client *client, MB_JSON_Stream *parser)
     {
         int ret = -1;
 
@@ -1421,7 +1517,7 @@ protected:
 
                                 if (headerEnded)
                                 {
-                                    buf.clear();
+                                    MB_JSON_StreamReset(parser);
                                     // parse header string to get the header field
                                     isHeader = false;
                                     parseRespHeader(header, response);
@@ -1463,7 +1559,8 @@ protected:
                                     if (availablePayload > 0)
                                     {
                                         payloadRead += availablePayload;
-                                        buf += pChunk;
+                                        // parse the payload as it arrives
+                                        MB_JSON_StreamFeed(parser, pChunk, strlen(pChunk), NULL);
                                     }
 
                                     delP(&pChunk);
@@ -1510,73 +1607,46 @@ protected:
 
     void clearSerialData(struct fb_js::serial_data_t &data)
     {
-        data.buf.clear();
-        data.start = -1;
-        data.end = -1;
+        MB_JSON_StreamReset(readParser);
         data.pos = -1;
-        data.scnt = 0;
-        data.ecnt = 0;
         data.dataTime = millis();
     }
 
-    bool readStreamChar(int r, struct fb_js::serial_data_t &data, MB_String &buf, bool isJson)
+    // Feed one byte to the parser, the bytes before the JSON begins are skipped.
+    // Returns true when the JSON is complete.
+    bool readStreamChar(int r, struct fb_js::serial_data_t &data)
     {
-        bool ret = false;
-        if (r > -1)
-        {
-            data.pos++;
+        if (r < 0)
+            return false;
 
-            if (isJson)
-            {
-                if ((char)r == '{')
-                {
-                    data.scnt++;
-                    data.start = data.pos;
-                }
-                else if ((char)r == '}')
-                {
-                    data.ecnt++;
-                    data.end = data.pos;
-                }
-            }
-            else
-            {
-                if ((char)r == '[')
-                {
-                    data.scnt++;
-                    data.start = data.pos;
-                }
-                else if ((char)r == ']')
-                {
-                    data.ecnt++;
-                    data.end = data.pos;
-                }
-            }
+        char c = (char)r;
 
-            if (data.scnt > 0)
-                data.buf += (char)r;
+        if (data.pos < 0)
+        {
+            if (c != (root_type == Root_Type_JSONArray ? '[' : '{'))
+                return false;
+            data.pos = 0;
+        }
 
-            if (data.scnt == data.ecnt && data.scnt > 0)
-            {
-                bool ret = false;
-                if (data.end > data.start)
-                {
-                    buf = data.buf.c_str();
-                    ret = true;
-                }
+        data.pos++;
 
-                clearSerialData(data);
-                return ret;
-            }
+        int ret = MB_JSON_StreamFeed(readParser, &c, 1, NULL);
 
-            if (data.ecnt > data.scnt)
-                clearSerialData(data);
+        // look for the next JSON after the malformed one
+        if (ret == MB_JSON_STREAM_ERROR)
+            clearSerialData(data);
+        else if (ret == MB_JSON_STREAM_DONE)
+        {
+            // the parsed JSON is kept until taken by mEndRead
+            data.pos = -1;
+            data.dataTime = millis();
+            return true;
         }
 
-        return ret;
+        return false;
     }
 
-    bool readStream(Stream *s, struct fb_js::serial_data_t &data, MB_String &buf, bool isJson, int timeoutMS)
+    bool readStream(Stream *s, struct fb_js::serial_data_t &data, int timeoutMS)
     {
 
         bool ret = false;
@@ -1589,17 +1659,14 @@ protected:
         else
             clearSerialData(data);
 
+        // read byte by byte to leave the data after the JSON in the stream
         while (s->available())
         {
             idle();
             int r = s->read();
-            ret = readStreamChar(r, data, buf, isJson);
+            ret = readStreamChar(r, data);
             if (ret)
-            {
-                if (timeoutMS == -1)
-                    clearSerialData(data);
                 return true;
-            }
         }
 
         return ret;
@@ -1607,7 +1674,7 @@ protected:
 
 #if defined(ESP32_SD_FAT_INCLUDED)
 
-    bool readSdFatFile(SD_FAT_FILE &file, struct fb_js::serial_data_t &data, MB_String &buf, bool isJson, int timeoutMS)
+    bool readSdFatFile(SD_FAT_FILE &file, struct fb_js::serial_data_t &data, int timeoutMS)
     {
 
         bool ret = false;
@@ -1624,13 +1691,9 @@ protected:
         {
             idle();
             int r = file.read();
-            ret = readStreamChar(r, data, buf, isJson);
+            ret = readStreamChar(r, data);
             if (ret)
-            {
-                if (timeoutMS == -1)
-                    clearSerialData(data);
                 return true;
-            }
         }
 
         return ret;
@@ -1750,6 +1813,16 @@ public:
         return ret;
     }
 
+    /**
+     * Deserialize the JSON array literal in place, without copying its keys and strings.
+     *
+     * @param data The JSON array literal string, its buffer is taken over and data is left empty.
+     * @return boolean status of the operation.
+     *
+     * @note The buffer is kept until the FirebaseJsonArray object is cleared or set again.
+     */
+    bool setJsonArrayDataInSitu(MB_String &data) { return mSetRawInSitu(data); }
+
     /**
      * Add null to FirebaseJsonArray object.
      *
@@ -1844,6 +1917,16 @@ public:
     template <typename T>
     bool get(FirebaseJsonData &result, T index_or_path, bool prettify = false) { return dataGetHandler(index_or_path, result, prettify); }
 
+    /**
+     * Get the FirebaseJsonArray data by a path that was split in advance.
+     *
+     * @param result The reference of FirebaseJsonData that holds the result.
+     * @param path The FirebaseJsonPath to be reused for repeated lookups.
+     * @param prettify The text indentation and new line serialization option.
+     * @return bool status for successful operation.
+     */
+    bool get(FirebaseJsonData &result, const FirebaseJsonPath &path, bool prettify = false) { return mGet(root, &result, path, prettify); }
+
     /**
      * Check whether key or path to the child element existed in FirebaseJsonArray or not.
      *
@@ -1996,6 +2079,15 @@ public:
      */
     void setDoubleDigits(uint8_t digits) { mSetDoubleDigits(digits); }
 
+    /**
+     * Parse into an arena instead of allocating every node and string separately.
+     * @param blockSize The arena block size in bytes, 0 to parse with the regular allocator again.
+     *
+     * @note The arena is rewound whenever the JSON is cleared or parsed again, which makes
+     * repeated parsing of similar responses allocation free after the first one.
+     */
+    void useArena(size_t blockSize = FBJS_ARENA_BLOCK_SIZE) { mUseArena(blockSize); }
+
     /**
      * Get http response code of reading JSON data from WiFi/Ethernet Client.
      * @return the response code of reading JSON data from WiFi/Ethernet Client
@@ -2321,6 +2413,16 @@ public:
         return ret;
     }
 
+    /**
+     * Deserialize the JSON object literal in place, without copying its keys and strings.
+     *
+     * @param data The JSON object literal string, its buffer is taken over and data is left empty.
+     * @return boolean status of the operation.
+     *
+     * @note The buffer is kept until the FirebaseJson object is cleared or set again.
+     */
+    bool setJsonDataInSitu(MB_String &data) { return mSetRawInSitu(data); }
+
     /**
      * Set JSON data via derived Stream object to FirebaseJson object.
      *
@@ -2466,6 +2568,19 @@ public:
         return ret;
     }
 
+    /**
+     * Get the FirebaseJson data by a path that was split in advance.
+     *
+     * @param result The reference of FirebaseJsonData that holds the result.
+     * @param path The FirebaseJsonPath to be reused for repeated lookups.
+     * @param prettify The text indentation and new line serialization option.
+     * @return bool status for successful operation.
+     *
+     * @note Large objects on the path get a hashed key index on first use which is
+     * kept until the JSON is modified.
+     */
+    bool get(FirebaseJsonData &result, const FirebaseJsonPath &path, bool prettify = false) { return mGet(root, &result, path, prettify); }
+
     /**
      * Check whether key or path to the child element existed in FirebaseJson object or not.
      *
@@ -2621,6 +2736,15 @@ public:
      */
     void setDoubleDigits(uint8_t digits) { mSetDoubleDigits(digits); }
 
+    /**
+     * Parse into an arena instead of allocating every node and string separately.
+     * @param blockSize The arena block size in bytes, 0 to parse with the regular allocator again.
+     *
+     * @note The arena is rewound whenever the JSON is cleared or parsed again, which makes
+     * repeated parsing of similar responses allocation free after the first one.
+     */
+    void useArena(size_t blockSize = FBJS_ARENA_BLOCK_SIZE) { mUseArena(blockSize); }
+
     /**
      * Get http response code of reading JSON data from WiFi/Ethernet Client.
      * @return the response code of reading JSON data from WiFi/Ethernet Client
@@ -69,6 +69,14 @@
 
 #include "MB_JSON.h"
 
+#if MB_JSON_FAST_SCAN
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#endif
+
 /* define our own boolean type */
 #ifdef true
 #undef true
@@ -279,7 +287,7 @@ MB_JSON_Delete(MB_JSON *item)
         {
             MB_JSON_Delete(item->child);
         }
-        if (!(item->type & MB_JSON_IsReference) && (item->valuestring != NULL))
+        if (!(item->type & (MB_JSON_IsReference | MB_JSON_ValueIsConst)) && (item->valuestring != NULL))
         {
             MB_JSON_global_hooks.deallocate(item->valuestring);
         }
@@ -287,7 +295,10 @@ MB_JSON_Delete(MB_JSON *item)
         {
             MB_JSON_global_hooks.deallocate(item->string);
         }
-        MB_JSON_global_hooks.deallocate(item);
+        if (!(item->type & MB_JSON_IsArena))
+        {
+            MB_JSON_global_hooks.deallocate(item);
+        }
         item = next;
     }
 }
@@ -310,6 +321,8 @@ typedef struct
     size_t offset;
     size_t depth; /* How deeply nested (in arrays/objects) is the input at the current offset. */
     MB_JSON_internal_hooks hooks;
+    MB_JSON_Arena *arena; /* when set, the parsed items and strings are taken from it */
+    MB_JSON_bool in_situ; /* decode the keys and strings into the content itself */
 } MB_JSON_parse_buffer;
 
 /* check if the given size is left to read in a given parse buffer (starting with 1) */
@@ -320,7 +333,266 @@ typedef struct
 /* get a pointer to the buffer at the position */
 #define MB_JSON_buffer_at_offset(buffer) ((buffer)->content + (buffer)->offset)
 
+typedef struct MB_JSON_arena_block
+{
+    struct MB_JSON_arena_block *next;
+    size_t size;
+    size_t used;
+} MB_JSON_arena_block;
+
+struct MB_JSON_Arena
+{
+    MB_JSON_arena_block *head; /* the block being filled, older blocks follow */
+    size_t block_size;
+};
+
+/* keep every allocation (and the block payload) aligned for double and pointers */
+#define MB_JSON_arena_align(size) (((size) + 7) & ~(size_t)7)
+#define MB_JSON_arena_header MB_JSON_arena_align(sizeof(MB_JSON_arena_block))
+
+static MB_JSON_arena_block *MB_JSON_arena_new_block(size_t size)
+{
+    MB_JSON_arena_block *block = (MB_JSON_arena_block *)MB_JSON_global_hooks.allocate(MB_JSON_arena_header + size);
+    if (block)
+    {
+        block->next = NULL;
+        block->size = size;
+        block->used = 0;
+    }
+    return block;
+}
+
+static void *MB_JSON_arena_alloc(MB_JSON_Arena *const arena, size_t size)
+{
+    MB_JSON_arena_block *block = arena->head;
+    size = MB_JSON_arena_align(size);
+
+    if (block == NULL || block->size - block->used < size)
+    {
+        block = MB_JSON_arena_new_block(size > arena->block_size ? size : arena->block_size);
+        if (block == NULL)
+        {
+            return NULL;
+        }
+
+        if (size > arena->block_size && arena->head != NULL)
+        {
+            /* oversized string, keep filling the current block */
+            block->next = arena->head->next;
+            arena->head->next = block;
+        }
+        else
+        {
+            block->next = arena->head;
+            arena->head = block;
+        }
+    }
+
+    block->used += size;
+    return (unsigned char *)block + MB_JSON_arena_header + block->used - size;
+}
+
+MB_JSON_PUBLIC(MB_JSON_Arena *)
+MB_JSON_ArenaCreate(size_t block_size)
+{
+    MB_JSON_Arena *arena = (MB_JSON_Arena *)MB_JSON_global_hooks.allocate(sizeof(MB_JSON_Arena));
+    if (arena)
+    {
+        arena->head = NULL;
+        arena->block_size = MB_JSON_arena_align(block_size > 0 ? block_size : 1);
+    }
+    return arena;
+}
+
+MB_JSON_PUBLIC(void)
+MB_JSON_ArenaReset(MB_JSON_Arena *arena)
+{
+    MB_JSON_arena_block *block = NULL;
+    MB_JSON_arena_block *next = NULL;
+
+    if (arena == NULL || arena->head == NULL)
+    {
+        return;
+    }
+
+    block = arena->head->next;
+    while (block)
+    {
+        next = block->next;
+        MB_JSON_global_hooks.deallocate(block);
+        block = next;
+    }
+
+    arena->head->next = NULL;
+    arena->head->used = 0;
+}
+
+MB_JSON_PUBLIC(void)
+MB_JSON_ArenaDestroy(MB_JSON_Arena *arena)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    MB_JSON_ArenaReset(arena);
+    if (arena->head)
+    {
+        MB_JSON_global_hooks.deallocate(arena->head);
+    }
+    MB_JSON_global_hooks.deallocate(arena);
+}
+
+static void *MB_JSON_parse_allocate(MB_JSON_parse_buffer *const input_buffer, size_t size)
+{
+    if (input_buffer->arena)
+    {
+        return MB_JSON_arena_alloc(input_buffer->arena, size);
+    }
+    return input_buffer->hooks.allocate(size);
+}
+
+static MB_JSON *MB_JSON_parse_new_item(MB_JSON_parse_buffer *const input_buffer)
+{
+    MB_JSON *node = (MB_JSON *)MB_JSON_parse_allocate(input_buffer, sizeof(MB_JSON));
+    if (node)
+    {
+        memset(node, '\0', sizeof(MB_JSON));
+    }
+
+    return node;
+}
+
+static void MB_JSON_mark_parsed(MB_JSON *item, int flags);
+
+/* Arena items are not freed one by one, the arena reset takes them. */
+static void MB_JSON_parse_delete(MB_JSON_parse_buffer *const input_buffer, MB_JSON *item)
+{
+    if (input_buffer->arena == NULL)
+    {
+        if (input_buffer->in_situ)
+        {
+            /* the strings belong to the content */
+            MB_JSON_mark_parsed(item, MB_JSON_ValueIsConst);
+        }
+        MB_JSON_Delete(item);
+    }
+}
+
+/* Flag the parsed tree so that MB_JSON_Delete and the setters leave the arena or in-situ memory alone. */
+static void MB_JSON_mark_parsed(MB_JSON *item, int flags)
+{
+    while (item != NULL)
+    {
+        item->type |= flags;
+        if (item->string != NULL)
+        {
+            item->type |= MB_JSON_StringIsConst;
+        }
+        if (item->child != NULL)
+        {
+            MB_JSON_mark_parsed(item->child, flags);
+        }
+        item = item->next;
+    }
+}
+
 /* Parse the input text to generate a number, and populate the result into item. */
+#if MB_JSON_FAST_NUMBER
+/* exactly representable powers of ten */
+static const double MB_JSON_pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/* Parse a number of at most 15 significant digits scaled by at most 10^22, which takes a single correctly
+ * rounded multiplication or division. Returns the parsed length, or 0 to leave the number to strtod. */
+static size_t MB_JSON_parse_short_number(const unsigned char *const input, size_t length, double *const number)
+{
+    unsigned long long mantissa = 0;
+    int digits = 0;
+    int scale = 0;
+    int exponent = 0;
+    MB_JSON_bool negative = false;
+    MB_JSON_bool exponent_negative = false;
+    size_t i = 0;
+
+    if (i < length && input[i] == '-')
+    {
+        negative = true;
+        i++;
+    }
+    if (i >= length || input[i] < '0' || input[i] > '9')
+    {
+        return 0;
+    }
+    for (; i < length && input[i] >= '0' && input[i] <= '9'; i++)
+    {
+        if (mantissa != 0 || input[i] != '0')
+        {
+            mantissa = mantissa * 10 + (unsigned long long)(input[i] - '0');
+            digits++;
+        }
+    }
+    if (i < length && input[i] == '.')
+    {
+        i++;
+        if (i >= length || input[i] < '0' || input[i] > '9')
+        {
+            return 0;
+        }
+        for (; i < length && input[i] >= '0' && input[i] <= '9'; i++)
+        {
+            if (mantissa != 0 || input[i] != '0')
+            {
+                mantissa = mantissa * 10 + (unsigned long long)(input[i] - '0');
+                digits++;
+            }
+            scale--;
+        }
+    }
+    if (i < length && (input[i] == 'e' || input[i] == 'E'))
+    {
+        i++;
+        if (i < length && (input[i] == '+' || input[i] == '-'))
+        {
+            exponent_negative = input[i] == '-';
+            i++;
+        }
+        if (i >= length || input[i] < '0' || input[i] > '9')
+        {
+            return 0;
+        }
+        for (; i < length && input[i] >= '0' && input[i] <= '9'; i++)
+        {
+            if (exponent > 1000)
+            {
+                return 0;
+            }
+            exponent = exponent * 10 + (input[i] - '0');
+        }
+    }
+
+    /* the copy for strtod stops at 63 characters */
+    if (digits > 15 || i > 63)
+    {
+        return 0;
+    }
+
+    scale += exponent_negative ? -exponent : exponent;
+    if (scale < -22 || scale > 22)
+    {
+        return 0;
+    }
+
+    *number = scale < 0 ? (double)mantissa / MB_JSON_pow10[-scale] : (double)mantissa * MB_JSON_pow10[scale];
+    if (negative)
+    {
+        *number = -*number;
+    }
+
+    return i;
+}
+#endif
+
 static MB_JSON_bool MB_JSON_parse_number(MB_JSON *const item, MB_JSON_parse_buffer *const input_buffer)
 {
     double number = 0;
@@ -334,6 +606,15 @@ static MB_JSON_bool MB_JSON_parse_number(MB_JSON *const item, MB_JSON_parse_buff
         return false;
     }
 
+#if MB_JSON_FAST_NUMBER
+    i = MB_JSON_parse_short_number(MB_JSON_buffer_at_offset(input_buffer), input_buffer->length - input_buffer->offset, &number);
+    if (i > 0)
+    {
+        after_end = number_c_string + i;
+        goto parsed;
+    }
+#endif
+
     /* copy the number into a temporary buffer and replace '.' with the decimal point
      * of the current locale (for strtod)
      * This also takes care of '\0' not necessarily being available for marking the end of the input */
@@ -375,6 +656,9 @@ loop_end:
         return false; /* parse_error */
     }
 
+#if MB_JSON_FAST_NUMBER
+parsed:
+#endif
     item->valuedouble = number;
 
     /* use saturation in case of overflow */
@@ -436,11 +720,12 @@ MB_JSON_SetValuestring(MB_JSON *object, const char *valuestring)
     {
         return NULL;
     }
-    if (object->valuestring != NULL)
+    if (object->valuestring != NULL && !(object->type & MB_JSON_ValueIsConst))
     {
         MB_JSON_free(object->valuestring);
     }
     object->valuestring = copy;
+    object->type &= ~MB_JSON_ValueIsConst;
 
     return copy;
 }
@@ -454,6 +739,12 @@ typedef struct
     MB_JSON_bool noalloc;
     MB_JSON_bool format; /* is this print a formatted print */
     MB_JSON_internal_hooks hooks;
+    MB_JSON_write_fn write_fn; /* when set, the printed text is flushed to write_fn instead of growing the buffer */
+    void *write_arg;
+    MB_JSON_trace_fn trace_fn; /* when set, called with the offsets of every printed item */
+    void *trace_arg;
+    size_t trace_key; /* offset of the key of the object member about to be printed */
+    MB_JSON_bool trace_keyed;
 } MB_JSON_printbuffer;
 
 typedef struct
@@ -492,6 +783,22 @@ static unsigned char *MB_JSON_ensure(MB_JSON_printbuffer *const p, size_t needed
         return p->buffer + p->offset;
     }
 
+    /* flush the printed text and reuse the buffer */
+    if (p->write_fn != NULL && p->offset > 0)
+    {
+        if (!p->write_fn(p->buffer, p->offset, p->write_arg))
+        {
+            return NULL;
+        }
+        needed -= p->offset;
+        p->offset = 0;
+        p->buffer[0] = '\0';
+        if (needed <= p->length)
+        {
+            return p->buffer;
+        }
+    }
+
     if (p->noalloc)
     {
         return NULL;
@@ -570,21 +877,89 @@ static MB_JSON_bool MB_JSON_compare_double(double a, double b)
     return (fabs(a - b) <= maxVal * DBL_EPSILON);
 }
 
-/* Render the number nicely from the given item into a string. */
-static MB_JSON_bool MB_JSON_print_number(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer)
+#if MB_JSON_FAST_NUMBER
+/* Print numbers of at most 15 significant digits that "%1.15g" prints without exponent, which gives the same text.
+ * Returns 0 for the others. */
+static int MB_JSON_format_short_number(double d, unsigned char *const number_buffer)
+{
+    unsigned char digits[18];
+    unsigned long long mantissa = 0;
+    double a = d < 0 ? -d : d;
+    int scale = 0;
+    int count = 0;
+    int length = 0;
+
+    if (!(a < 1e15) || (a != 0 && a < 1e-4))
+    {
+        return 0;
+    }
+
+    /* the fewest decimals that still read back as d */
+    for (scale = 0; scale <= 15; scale++)
+    {
+        double scaled = a * MB_JSON_pow10[scale];
+        if (scaled >= 1e15)
+        {
+            return 0;
+        }
+        mantissa = (unsigned long long)(scaled + 0.5);
+        if ((double)mantissa / MB_JSON_pow10[scale] == a)
+        {
+            break;
+        }
+    }
+    if (scale > 15)
+    {
+        return 0;
+    }
+
+    while (scale > 0 && mantissa % 10 == 0)
+    {
+        mantissa /= 10;
+        scale--;
+    }
+
+    do
+    {
+        digits[count++] = (unsigned char)('0' + mantissa % 10);
+        mantissa /= 10;
+    } while (mantissa > 0);
+    while (count <= scale)
+    {
+        digits[count++] = '0';
+    }
+
+    if (signbit(d))
+    {
+        number_buffer[length++] = '-';
+    }
+    while (count > 0)
+    {
+        number_buffer[length++] = digits[--count];
+        if (count == scale && scale > 0)
+        {
+            number_buffer[length++] = '.';
+        }
+    }
+    number_buffer[length] = '\0';
+
+    return length;
+}
+#endif
+
+/* Print the number into number_buffer (at least 26 bytes) and return its length. */
+static int MB_JSON_format_number(double d, unsigned char *const number_buffer)
 {
-    unsigned char *output_pointer = NULL;
-    double d = item->valuedouble;
     int length = 0;
-    size_t i = 0;
-    unsigned char number_buffer[26] = {0}; /* temporary buffer to print the number into */
-    unsigned char decimal_point = MB_JSON_get_decimal_point();
     double test = 0.0;
 
-    if (output_buffer == NULL)
+#if MB_JSON_FAST_NUMBER
+    length = MB_JSON_format_short_number(d, number_buffer);
+    if (length > 0)
     {
-        return false;
+        return length;
     }
+#endif
 
     /* This checks for NaN and Infinity */
     if (isnan(d) || isinf(d))
@@ -604,6 +979,25 @@ static MB_JSON_bool MB_JSON_print_number(const MB_JSON *const item, MB_JSON_prin
         }
     }
 
+    return length;
+}
+
+/* Render the number nicely from the given item into a string. */
+static MB_JSON_bool MB_JSON_print_number(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer)
+{
+    unsigned char *output_pointer = NULL;
+    int length = 0;
+    size_t i = 0;
+    unsigned char number_buffer[26] = {0}; /* temporary buffer to print the number into */
+    unsigned char decimal_point = MB_JSON_get_decimal_point();
+
+    if (output_buffer == NULL)
+    {
+        return false;
+    }
+
+    length = MB_JSON_format_number(item->valuedouble, number_buffer);
+
     /* sprintf failed or buffer overrun occurred */
     if ((length < 0) || (length > (int)(sizeof(number_buffer) - 1)))
     {
@@ -793,47 +1187,158 @@ fail:
     return 0;
 }
 
-/* Parse the input text into an unescaped cinput, and populate item. */
-static MB_JSON_bool MB_JSON_parse_string(MB_JSON *const item, MB_JSON_parse_buffer *const input_buffer)
-{
-    const unsigned char *input_pointer = MB_JSON_buffer_at_offset(input_buffer) + 1;
-    const unsigned char *input_end = MB_JSON_buffer_at_offset(input_buffer) + 1;
-    unsigned char *output_pointer = NULL;
-    unsigned char *output = NULL;
+#if MB_JSON_FAST_SCAN
+#define MB_JSON_word_ones ((size_t)-1 / 0xFF)
+#define MB_JSON_word_highs (MB_JSON_word_ones * 0x80)
+/* non zero when any byte of the word is zero */
+#define MB_JSON_word_has_zero(word) (((word) - MB_JSON_word_ones) & ~(word) & MB_JSON_word_highs)
 
-    /* not a string */
-    if (MB_JSON_buffer_at_offset(input_buffer)[0] != '\"')
-    {
-        goto fail;
+/* Returns the first quote or backslash in [pointer, end), or end. */
+static const unsigned char *MB_JSON_skip_plain(const unsigned char *pointer, const unsigned char *const end)
+{
+#if defined(__SSE2__)
+    const __m128i quotes = _mm_set1_epi8('\"');
+    const __m128i backslashes = _mm_set1_epi8('\\');
+    while (end - pointer >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)pointer);
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, quotes), _mm_cmpeq_epi8(chunk, backslashes)));
+        if (mask != 0)
+        {
+            return pointer + __builtin_ctz((unsigned int)mask);
+        }
+        pointer += 16;
     }
-
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const uint8x16_t quotes = vdupq_n_u8('\"');
+    const uint8x16_t backslashes = vdupq_n_u8('\\');
+    while (end - pointer >= 16)
     {
-        /* calculate approximate size of the output (overestimate) */
-        size_t allocation_length = 0;
-        size_t skipped_bytes = 0;
-        while (((size_t)(input_end - input_buffer->content) < input_buffer->length) && (*input_end != '\"'))
+        uint8x16_t chunk = vld1q_u8(pointer);
+        if (vmaxvq_u8(vorrq_u8(vceqq_u8(chunk, quotes), vceqq_u8(chunk, backslashes))) != 0)
         {
-            /* is escape sequence */
-            if (input_end[0] == '\\')
-            {
-                if ((size_t)(input_end + 1 - input_buffer->content) >= input_buffer->length)
-                {
-                    /* prevent buffer overflow when last input character is a backslash */
-                    goto fail;
-                }
-                skipped_bytes++;
-                input_end++;
-            }
-            input_end++;
+            break;
         }
-        if (((size_t)(input_end - input_buffer->content) >= input_buffer->length) || (*input_end != '\"'))
+        pointer += 16;
+    }
+#endif
+
+    while ((size_t)(end - pointer) >= sizeof(size_t))
+    {
+        size_t word;
+        size_t found;
+        memcpy(&word, pointer, sizeof(word));
+        found = MB_JSON_word_has_zero(word ^ (MB_JSON_word_ones * '\"')) | MB_JSON_word_has_zero(word ^ (MB_JSON_word_ones * '\\'));
+        if (found != 0)
         {
-            goto fail; /* string ended unexpectedly */
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+            /* the lowest flagged byte is always a real match */
+            return pointer + (sizeof(size_t) == sizeof(unsigned long long) ? __builtin_ctzll((unsigned long long)found) : __builtin_ctz((unsigned int)found)) / 8;
+#else
+            break;
+#endif
         }
+        pointer += sizeof(size_t);
+    }
 
-        /* This is at most how much we need for the output */
+    while ((pointer < end) && (*pointer != '\"') && (*pointer != '\\'))
+    {
+        pointer++;
+    }
+
+    return pointer;
+}
+
+/* Returns the first byte above 32 in [pointer, end), or end. */
+static const unsigned char *MB_JSON_skip_space(const unsigned char *pointer, const unsigned char *const end)
+{
+    /* whitespace runs are short, look at single bytes until the run turns out to be indentation */
+    int count = 0;
+    for (; (count < 4) && (pointer < end); count++, pointer++)
+    {
+        if (*pointer > 32)
+        {
+            return pointer;
+        }
+    }
+
+    while ((size_t)(end - pointer) >= sizeof(size_t))
+    {
+        size_t word;
+        memcpy(&word, pointer, sizeof(word));
+        /* bytes above 32 carry into (or already have) the high bit */
+        if (((word + MB_JSON_word_ones * (0x80 - 33)) | word) & MB_JSON_word_highs)
+        {
+            break;
+        }
+        pointer += sizeof(size_t);
+    }
+
+    while ((pointer < end) && (*pointer <= 32))
+    {
+        pointer++;
+    }
+
+    return pointer;
+}
+#endif
+
+/* Parse the input text into an unescaped cinput, and populate item. */
+static MB_JSON_bool MB_JSON_parse_string(MB_JSON *const item, MB_JSON_parse_buffer *const input_buffer)
+{
+    const unsigned char *input_pointer = MB_JSON_buffer_at_offset(input_buffer) + 1;
+    const unsigned char *input_end = MB_JSON_buffer_at_offset(input_buffer) + 1;
+    unsigned char *output_pointer = NULL;
+    unsigned char *output = NULL;
+
+    /* not a string, or the input ended before the opening quote */
+    if (MB_JSON_cannot_access_at_index(input_buffer, 0) || (MB_JSON_buffer_at_offset(input_buffer)[0] != '\"'))
+    {
+        goto fail;
+    }
+
+    {
+        /* calculate approximate size of the output (overestimate) */
+        size_t allocation_length = 0;
+        size_t skipped_bytes = 0;
+#if MB_JSON_FAST_SCAN
+        const unsigned char *const content_end = input_buffer->content + input_buffer->length;
+        while ((input_end = MB_JSON_skip_plain(input_end, content_end)) < content_end && (*input_end == '\\'))
+        {
+            if (input_end + 1 >= content_end)
+            {
+                /* prevent buffer overflow when last input character is a backslash */
+                goto fail;
+            }
+            skipped_bytes++;
+            input_end += 2;
+        }
+#else
+        while (((size_t)(input_end - input_buffer->content) < input_buffer->length) && (*input_end != '\"'))
+        {
+            /* is escape sequence */
+            if (input_end[0] == '\\')
+            {
+                if ((size_t)(input_end + 1 - input_buffer->content) >= input_buffer->length)
+                {
+                    /* prevent buffer overflow when last input character is a backslash */
+                    goto fail;
+                }
+                skipped_bytes++;
+                input_end++;
+            }
+            input_end++;
+        }
+#endif
+        if (((size_t)(input_end - input_buffer->content) >= input_buffer->length) || (*input_end != '\"'))
+        {
+            goto fail; /* string ended unexpectedly */
+        }
+
+        /* This is at most how much we need for the output */
         allocation_length = (size_t)(input_end - MB_JSON_buffer_at_offset(input_buffer)) - skipped_bytes;
-        output = (unsigned char *)input_buffer->hooks.allocate(allocation_length + sizeof(""));
+        /* the decoded string is never longer than its literal, which ends with the quote that takes the terminator */
+        output = input_buffer->in_situ ? (unsigned char *)input_pointer : (unsigned char *)MB_JSON_parse_allocate(input_buffer, allocation_length + sizeof(""));
         if (output == NULL)
         {
             goto fail; /* allocation failure */
@@ -844,10 +1349,24 @@ static MB_JSON_bool MB_JSON_parse_string(MB_JSON *const item, MB_JSON_parse_buff
     /* loop through the string literal */
     while (input_pointer < input_end)
     {
+#if MB_JSON_FAST_SCAN
+        if (*input_pointer != '\\')
+        {
+            /* copy the run up to the next escape sequence at once, the first byte may be a quote left by a malformed unicode escape */
+            const unsigned char *run_end = MB_JSON_skip_plain(input_pointer + 1, input_end);
+            if (output_pointer != input_pointer)
+            {
+                memmove(output_pointer, input_pointer, (size_t)(run_end - input_pointer));
+            }
+            output_pointer += run_end - input_pointer;
+            input_pointer = run_end;
+        }
+#else
         if (*input_pointer != '\\')
         {
             *output_pointer++ = *input_pointer++;
         }
+#endif
         /* escape sequence */
         else
         {
@@ -909,7 +1428,7 @@ static MB_JSON_bool MB_JSON_parse_string(MB_JSON *const item, MB_JSON_parse_buff
     return true;
 
 fail:
-    if (output != NULL)
+    if (output != NULL && input_buffer->arena == NULL && !input_buffer->in_situ)
     {
         input_buffer->hooks.deallocate(output);
     }
@@ -1102,6 +1621,7 @@ static MB_JSON_bool MB_JSON_print_string(const MB_JSON *const item, MB_JSON_prin
 
 /* Predeclare these prototypes. */
 static MB_JSON_bool MB_JSON_parse_value(MB_JSON *const item, MB_JSON_parse_buffer *const input_buffer);
+static MB_JSON *MB_JSON_parse_root(const char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated, MB_JSON_Arena *arena, MB_JSON_bool in_situ);
 static MB_JSON_bool MB_JSON_print_value(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer);
 static MB_JSON_bool MB_JSON_parse_array(MB_JSON *const item, MB_JSON_parse_buffer *const input_buffer);
 static MB_JSON_bool MB_JSON_print_array(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer);
@@ -1112,156 +1632,698 @@ static MB_JSON_bool MB_JSON_get_object_buffer_length(const MB_JSON *const item,
 static MB_JSON_bool MB_JSON_get_array_buffer_length(const MB_JSON *const item, MB_JSON_buffer_len_data_t *const buf_len);
 static MB_JSON_bool MB_JSON_get_value_buffer_length(const MB_JSON *const item, MB_JSON_buffer_len_data_t *const buf_len);
 
-/* Utility to jump whitespace and cr/lf */
-static MB_JSON_parse_buffer *MB_JSON_buffer_skip_whitespace(MB_JSON_parse_buffer *const buffer)
+/* Utility to jump whitespace and cr/lf */
+static MB_JSON_parse_buffer *MB_JSON_buffer_skip_whitespace(MB_JSON_parse_buffer *const buffer)
+{
+    if ((buffer == NULL) || (buffer->content == NULL))
+    {
+        return NULL;
+    }
+
+    if (MB_JSON_cannot_access_at_index(buffer, 0))
+    {
+        return buffer;
+    }
+
+#if MB_JSON_FAST_SCAN
+    buffer->offset = (size_t)(MB_JSON_skip_space(MB_JSON_buffer_at_offset(buffer), buffer->content + buffer->length) - buffer->content);
+#else
+    while (MB_JSON_can_access_at_index(buffer, 0) && (MB_JSON_buffer_at_offset(buffer)[0] <= 32))
+    {
+        buffer->offset++;
+    }
+#endif
+
+    if (buffer->offset == buffer->length)
+    {
+        buffer->offset--;
+    }
+
+    return buffer;
+}
+
+/* skip the UTF-8 BOM (byte order mark) if it is at the beginning of a buffer */
+static MB_JSON_parse_buffer *MB_JSON_skip_utf8_bom(MB_JSON_parse_buffer *const buffer)
+{
+    if ((buffer == NULL) || (buffer->content == NULL) || (buffer->offset != 0))
+    {
+        return NULL;
+    }
+
+    if (MB_JSON_can_access_at_index(buffer, 4) && (strncmp((const char *)MB_JSON_buffer_at_offset(buffer), "\xEF\xBB\xBF", 3) == 0))
+    {
+        buffer->offset += 3;
+    }
+
+    return buffer;
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ParseWithOpts(const char *value, const char **return_parse_end, MB_JSON_bool require_null_terminated)
+{
+    size_t buffer_length;
+
+    if (NULL == value)
+    {
+        return NULL;
+    }
+
+    /* Adding null character size due to require_null_terminated. */
+    buffer_length = strlen(value) + sizeof("");
+
+    return MB_JSON_ParseWithLengthOpts(value, buffer_length, return_parse_end, require_null_terminated);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ParseWithArena(const char *value, const char **return_parse_end, MB_JSON_bool require_null_terminated, MB_JSON_Arena *arena)
+{
+    if (NULL == value)
+    {
+        return NULL;
+    }
+
+    return MB_JSON_parse_root(value, strlen(value) + sizeof(""), return_parse_end, require_null_terminated, arena, false);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ParseInSitu(char *value, const char **return_parse_end, MB_JSON_bool require_null_terminated, MB_JSON_Arena *arena)
+{
+    if (NULL == value)
+    {
+        return NULL;
+    }
+
+    return MB_JSON_parse_root(value, strlen(value) + sizeof(""), return_parse_end, require_null_terminated, arena, true);
+}
+
+/* Parse an object - create a new root, and populate. */
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated)
+{
+    return MB_JSON_parse_root(value, buffer_length, return_parse_end, require_null_terminated, NULL, false);
+}
+
+static MB_JSON *MB_JSON_parse_root(const char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated, MB_JSON_Arena *arena, MB_JSON_bool in_situ)
+{
+    MB_JSON_parse_buffer buffer = {0, 0, 0, 0, {0, 0, 0}, 0, 0};
+    MB_JSON *item = NULL;
+
+    /* reset error position */
+    MB_JSON_global_error.json = NULL;
+    MB_JSON_global_error.position = 0;
+
+    if (value == NULL || 0 == buffer_length)
+    {
+        goto fail;
+    }
+
+    buffer.content = (const unsigned char *)value;
+    buffer.length = buffer_length;
+    buffer.offset = 0;
+    buffer.hooks = MB_JSON_global_hooks;
+    buffer.arena = arena;
+    buffer.in_situ = in_situ;
+
+    item = MB_JSON_parse_new_item(&buffer);
+    if (item == NULL) /* memory fail */
+    {
+        goto fail;
+    }
+
+    if (!MB_JSON_parse_value(item, MB_JSON_buffer_skip_whitespace(MB_JSON_skip_utf8_bom(&buffer))))
+    {
+        /* parse failure. ep is set. */
+        goto fail;
+    }
+
+    /* if we require null-terminated JSON without appended garbage, skip and then check for a null terminator */
+    if (require_null_terminated)
+    {
+        MB_JSON_buffer_skip_whitespace(&buffer);
+        if ((buffer.offset >= buffer.length) || MB_JSON_buffer_at_offset(&buffer)[0] != '\0')
+        {
+            goto fail;
+        }
+    }
+    if (return_parse_end)
+    {
+        *return_parse_end = (const char *)MB_JSON_buffer_at_offset(&buffer);
+    }
+
+    if (arena)
+    {
+        MB_JSON_mark_parsed(item, MB_JSON_IsArena | MB_JSON_ValueIsConst);
+    }
+    else if (in_situ)
+    {
+        MB_JSON_mark_parsed(item, MB_JSON_ValueIsConst);
+    }
+
+    return item;
+
+fail:
+    if (item != NULL)
+    {
+        MB_JSON_parse_delete(&buffer, item);
+    }
+
+    if (value != NULL)
+    {
+        MB_JSON_error local_error;
+        local_error.json = (const unsigned char *)value;
+        local_error.position = 0;
+
+        if (buffer.offset < buffer.length)
+        {
+            local_error.position = buffer.offset;
+        }
+        else if (buffer.length > 0)
+        {
+            local_error.position = buffer.length - 1;
+        }
+
+        if (return_parse_end != NULL)
+        {
+            *return_parse_end = (const char *)local_error.json + local_error.position;
+        }
+
+        MB_JSON_global_error = local_error;
+    }
+
+    return NULL;
+}
+
+/* Default options for MB_JSON_Parse */
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_Parse(const char *value)
+{
+    return MB_JSON_ParseWithOpts(value, 0, 0);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ParseWithLength(const char *value, size_t buffer_length)
+{
+    return MB_JSON_ParseWithLengthOpts(value, buffer_length, 0, 0);
+}
+
+static MB_JSON_bool MB_JSON_add_item_to_array(MB_JSON *array, MB_JSON *item);
+
+typedef enum
+{
+    MB_JSON_stream_value,       /* before a value */
+    MB_JSON_stream_first_value, /* after '[' */
+    MB_JSON_stream_first_key,   /* after '{' */
+    MB_JSON_stream_key,         /* after ',' in an object */
+    MB_JSON_stream_colon,
+    MB_JSON_stream_next,        /* after a value in an array or object */
+    MB_JSON_stream_string,
+    MB_JSON_stream_key_string,
+    MB_JSON_stream_number,
+    MB_JSON_stream_literal,
+    MB_JSON_stream_done,
+    MB_JSON_stream_error
+} MB_JSON_stream_state;
+
+struct MB_JSON_Stream
+{
+    MB_JSON *root;
+    MB_JSON *item;   /* the value being parsed */
+    MB_JSON **stack; /* the open arrays and objects */
+    size_t depth;
+    size_t stack_size;
+    size_t max_depth;
+    size_t max_size;
+    size_t size;          /* bytes of the current JSON fed so far */
+    unsigned char *token; /* the string, number or literal that may span the slices */
+    size_t token_length;
+    size_t token_size;
+    MB_JSON_stream_state state;
+    MB_JSON_bool escaped;
+};
+
+MB_JSON_PUBLIC(MB_JSON_Stream *)
+MB_JSON_StreamCreate(size_t max_depth, size_t max_size)
+{
+    MB_JSON_Stream *stream = (MB_JSON_Stream *)MB_JSON_global_hooks.allocate(sizeof(MB_JSON_Stream));
+    if (stream == NULL)
+    {
+        return NULL;
+    }
+
+    memset(stream, '\0', sizeof(MB_JSON_Stream));
+    stream->max_depth = max_depth > 0 ? max_depth : MB_JSON_NESTING_LIMIT;
+    stream->max_size = max_size;
+    stream->state = MB_JSON_stream_value;
+
+    return stream;
+}
+
+MB_JSON_PUBLIC(void)
+MB_JSON_StreamReset(MB_JSON_Stream *stream)
+{
+    if (stream == NULL)
+    {
+        return;
+    }
+
+    MB_JSON_Delete(stream->root);
+    stream->root = NULL;
+    stream->item = NULL;
+    stream->depth = 0;
+    stream->size = 0;
+    stream->token_length = 0;
+    stream->state = MB_JSON_stream_value;
+    stream->escaped = false;
+}
+
+MB_JSON_PUBLIC(void)
+MB_JSON_StreamDestroy(MB_JSON_Stream *stream)
+{
+    if (stream == NULL)
+    {
+        return;
+    }
+
+    MB_JSON_StreamReset(stream);
+    if (stream->stack != NULL)
+    {
+        MB_JSON_global_hooks.deallocate(stream->stack);
+    }
+    if (stream->token != NULL)
+    {
+        MB_JSON_global_hooks.deallocate(stream->token);
+    }
+    MB_JSON_global_hooks.deallocate(stream);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_StreamTake(MB_JSON_Stream *stream)
+{
+    MB_JSON *root = NULL;
+
+    if ((stream == NULL) || (stream->state != MB_JSON_stream_done))
+    {
+        return NULL;
+    }
+
+    root = stream->root;
+    stream->root = NULL;
+    MB_JSON_StreamReset(stream);
+
+    return root;
+}
+
+static MB_JSON_bool MB_JSON_stream_append(MB_JSON_Stream *const stream, const unsigned char *const data, size_t length)
+{
+    if (stream->token_length + length + 1 > stream->token_size)
+    {
+        size_t size = stream->token_size > 0 ? stream->token_size : 32;
+        unsigned char *token = NULL;
+        while (size < stream->token_length + length + 1)
+        {
+            size *= 2;
+        }
+
+        /* the hooks may come without realloc */
+        token = (unsigned char *)MB_JSON_global_hooks.allocate(size);
+        if (token == NULL)
+        {
+            return false;
+        }
+        if (stream->token != NULL)
+        {
+            memcpy(token, stream->token, stream->token_length);
+            MB_JSON_global_hooks.deallocate(stream->token);
+        }
+        stream->token = token;
+        stream->token_size = size;
+    }
+
+    memcpy(stream->token + stream->token_length, data, length);
+    stream->token_length += length;
+
+    return true;
+}
+
+/* The item that takes the next value, the keyed item of an object was already added with its key. */
+static MB_JSON *MB_JSON_stream_begin_value(MB_JSON_Stream *const stream)
+{
+    MB_JSON *item = NULL;
+
+    if ((stream->depth > 0) && ((stream->stack[stream->depth - 1]->type & 0xFF) == MB_JSON_Object))
+    {
+        return stream->item;
+    }
+
+    item = MB_JSON_New_Item(&MB_JSON_global_hooks);
+    if (item == NULL)
+    {
+        return NULL;
+    }
+
+    if (stream->depth > 0)
+    {
+        MB_JSON_add_item_to_array(stream->stack[stream->depth - 1], item);
+    }
+    else
+    {
+        stream->root = item;
+    }
+    stream->item = item;
+
+    return item;
+}
+
+static MB_JSON_bool MB_JSON_stream_push(MB_JSON_Stream *const stream, MB_JSON *const item)
+{
+    if (stream->depth >= stream->max_depth)
+    {
+        return false; /* too deeply nested */
+    }
+
+    if (stream->depth == stream->stack_size)
+    {
+        size_t size = stream->stack_size > 0 ? stream->stack_size * 2 : 8;
+        MB_JSON **stack = (MB_JSON **)MB_JSON_global_hooks.allocate(size * sizeof(MB_JSON *));
+        if (stack == NULL)
+        {
+            return false;
+        }
+        if (stream->stack != NULL)
+        {
+            memcpy(stack, stream->stack, stream->depth * sizeof(MB_JSON *));
+            MB_JSON_global_hooks.deallocate(stream->stack);
+        }
+        stream->stack = stack;
+        stream->stack_size = size;
+    }
+
+    stream->stack[stream->depth++] = item;
+
+    return true;
+}
+
+static void MB_JSON_stream_end_value(MB_JSON_Stream *const stream)
 {
-    if ((buffer == NULL) || (buffer->content == NULL))
-    {
-        return NULL;
-    }
+    stream->token_length = 0;
+    stream->state = stream->depth > 0 ? MB_JSON_stream_next : MB_JSON_stream_done;
+}
 
-    if (MB_JSON_cannot_access_at_index(buffer, 0))
-    {
-        return buffer;
-    }
+/* Parse the completed string or number token with the regular parser. */
+static MB_JSON_bool MB_JSON_stream_parse_token(MB_JSON_Stream *const stream, MB_JSON *const item)
+{
+    MB_JSON_parse_buffer buffer = {0, 0, 0, 0, {0, 0, 0}, 0, 0};
+    MB_JSON_bool parsed = false;
 
-    while (MB_JSON_can_access_at_index(buffer, 0) && (MB_JSON_buffer_at_offset(buffer)[0] <= 32))
+    buffer.content = stream->token;
+    buffer.length = stream->token_length;
+    buffer.hooks = MB_JSON_global_hooks;
+
+    if (stream->token[0] == '\"')
     {
-        buffer->offset++;
+        parsed = MB_JSON_parse_string(item, &buffer);
     }
-
-    if (buffer->offset == buffer->length)
+    else
     {
-        buffer->offset--;
+        parsed = MB_JSON_parse_number(item, &buffer);
     }
 
-    return buffer;
+    return parsed && (buffer.offset == buffer.length);
 }
 
-/* skip the UTF-8 BOM (byte order mark) if it is at the beginning of a buffer */
-static MB_JSON_parse_buffer *MB_JSON_skip_utf8_bom(MB_JSON_parse_buffer *const buffer)
+static MB_JSON_bool MB_JSON_stream_parse_literal(MB_JSON_Stream *const stream, MB_JSON *const item)
 {
-    if ((buffer == NULL) || (buffer->content == NULL) || (buffer->offset != 0))
+    if ((stream->token_length == 4) && (strncmp((const char *)stream->token, "null", 4) == 0))
     {
-        return NULL;
+        item->type = MB_JSON_NULL;
     }
-
-    if (MB_JSON_can_access_at_index(buffer, 4) && (strncmp((const char *)MB_JSON_buffer_at_offset(buffer), "\xEF\xBB\xBF", 3) == 0))
+    else if ((stream->token_length == 5) && (strncmp((const char *)stream->token, "false", 5) == 0))
     {
-        buffer->offset += 3;
+        item->type = MB_JSON_False;
+    }
+    else if ((stream->token_length == 4) && (strncmp((const char *)stream->token, "true", 4) == 0))
+    {
+        item->type = MB_JSON_True;
+        item->valueint = 1;
+    }
+    else
+    {
+        return false;
     }
 
-    return buffer;
+    return true;
 }
 
-MB_JSON_PUBLIC(MB_JSON *)
-MB_JSON_ParseWithOpts(const char *value, const char **return_parse_end, MB_JSON_bool require_null_terminated)
+static MB_JSON_bool MB_JSON_stream_is_number_char(unsigned char c)
 {
-    size_t buffer_length;
+    return ((c >= '0') && (c <= '9')) || (c == '+') || (c == '-') || (c == '.') || (c == 'e') || (c == 'E');
+}
 
-    if (NULL == value)
+static MB_JSON_bool MB_JSON_stream_is_literal_char(unsigned char c)
+{
+    return (c >= 'a') && (c <= 'z');
+}
+
+/* Take the byte in a structural state, returns false on a syntax error. */
+static MB_JSON_bool MB_JSON_stream_structure(MB_JSON_Stream *const stream, unsigned char c)
+{
+    MB_JSON *item = NULL;
+    MB_JSON *parent = stream->depth > 0 ? stream->stack[stream->depth - 1] : NULL;
+
+    if (c <= 32)
     {
-        return NULL;
+        return true; /* whitespace */
     }
 
-    /* Adding null character size due to require_null_terminated. */
-    buffer_length = strlen(value) + sizeof("");
+    switch (stream->state)
+    {
+    case MB_JSON_stream_first_value:
+        if (c == ']')
+        {
+            stream->depth--;
+            MB_JSON_stream_end_value(stream);
+            return true;
+        }
+        /* fall through */
+    case MB_JSON_stream_value:
+        item = MB_JSON_stream_begin_value(stream);
+        if (item == NULL)
+        {
+            return false;
+        }
+        if ((c == '{') || (c == '['))
+        {
+            item->type = (c == '{') ? MB_JSON_Object : MB_JSON_Array;
+            stream->state = (c == '{') ? MB_JSON_stream_first_key : MB_JSON_stream_first_value;
+            return MB_JSON_stream_push(stream, item);
+        }
+        stream->token_length = 0;
+        if (c == '\"')
+        {
+            stream->state = MB_JSON_stream_string;
+        }
+        else if ((c == '-') || ((c >= '0') && (c <= '9')))
+        {
+            stream->state = MB_JSON_stream_number;
+        }
+        else if ((c == 't') || (c == 'f') || (c == 'n'))
+        {
+            stream->state = MB_JSON_stream_literal;
+        }
+        else
+        {
+            return false;
+        }
+        return MB_JSON_stream_append(stream, &c, 1);
 
-    return MB_JSON_ParseWithLengthOpts(value, buffer_length, return_parse_end, require_null_terminated);
+    case MB_JSON_stream_first_key:
+        if (c == '}')
+        {
+            stream->depth--;
+            MB_JSON_stream_end_value(stream);
+            return true;
+        }
+        /* fall through */
+    case MB_JSON_stream_key:
+        if (c != '\"')
+        {
+            return false;
+        }
+        stream->token_length = 0;
+        stream->state = MB_JSON_stream_key_string;
+        return MB_JSON_stream_append(stream, &c, 1);
+
+    case MB_JSON_stream_colon:
+        stream->state = MB_JSON_stream_value;
+        return c == ':';
+
+    case MB_JSON_stream_next:
+        if (c == ',')
+        {
+            stream->state = ((parent->type & 0xFF) == MB_JSON_Object) ? MB_JSON_stream_key : MB_JSON_stream_value;
+            return true;
+        }
+        if (c == (((parent->type & 0xFF) == MB_JSON_Object) ? '}' : ']'))
+        {
+            stream->depth--;
+            MB_JSON_stream_end_value(stream);
+            return true;
+        }
+        return false;
+
+    default:
+        return false;
+    }
 }
 
-/* Parse an object - create a new root, and populate. */
-MB_JSON_PUBLIC(MB_JSON *)
-MB_JSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated)
+/* The closing quote was appended, parse the string into the value or into a new keyed item. */
+static MB_JSON_bool MB_JSON_stream_end_string(MB_JSON_Stream *const stream)
 {
-    MB_JSON_parse_buffer buffer = {0, 0, 0, 0, {0, 0, 0}};
     MB_JSON *item = NULL;
 
-    /* reset error position */
-    MB_JSON_global_error.json = NULL;
-    MB_JSON_global_error.position = 0;
-
-    if (value == NULL || 0 == buffer_length)
+    if (stream->state == MB_JSON_stream_string)
     {
-        goto fail;
+        if (!MB_JSON_stream_parse_token(stream, stream->item))
+        {
+            return false;
+        }
+        MB_JSON_stream_end_value(stream);
+        return true;
     }
 
-    buffer.content = (const unsigned char *)value;
-    buffer.length = buffer_length;
-    buffer.offset = 0;
-    buffer.hooks = MB_JSON_global_hooks;
-
     item = MB_JSON_New_Item(&MB_JSON_global_hooks);
-    if (item == NULL) /* memory fail */
+    if (item == NULL)
     {
-        goto fail;
+        return false;
     }
-
-    if (!MB_JSON_parse_value(item, MB_JSON_buffer_skip_whitespace(MB_JSON_skip_utf8_bom(&buffer))))
+    if (!MB_JSON_stream_parse_token(stream, item))
     {
-        /* parse failure. ep is set. */
-        goto fail;
+        MB_JSON_Delete(item);
+        return false;
     }
 
-    /* if we require null-terminated JSON without appended garbage, skip and then check for a null terminator */
-    if (require_null_terminated)
+    /* swap valuestring and string, because we parsed the name */
+    item->string = item->valuestring;
+    item->valuestring = NULL;
+    item->type = MB_JSON_Invalid;
+    MB_JSON_add_item_to_array(stream->stack[stream->depth - 1], item);
+    stream->item = item;
+    stream->token_length = 0;
+    stream->state = MB_JSON_stream_colon;
+
+    return true;
+}
+
+MB_JSON_PUBLIC(int)
+MB_JSON_StreamFeed(MB_JSON_Stream *stream, const char *data, size_t length, size_t *consumed)
+{
+    const unsigned char *input = (const unsigned char *)data;
+    size_t limit = length;
+    size_t i = 0;
+
+    if (consumed != NULL)
     {
-        MB_JSON_buffer_skip_whitespace(&buffer);
-        if ((buffer.offset >= buffer.length) || MB_JSON_buffer_at_offset(&buffer)[0] != '\0')
-        {
-            goto fail;
-        }
+        *consumed = 0;
     }
-    if (return_parse_end)
+
+    if ((stream == NULL) || ((data == NULL) && (length > 0)))
     {
-        *return_parse_end = (const char *)MB_JSON_buffer_at_offset(&buffer);
+        return MB_JSON_STREAM_ERROR;
     }
 
-    return item;
-
-fail:
-    if (item != NULL)
+    if ((stream->max_size > 0) && (limit > stream->max_size - stream->size))
     {
-        MB_JSON_Delete(item);
+        limit = stream->max_size - stream->size;
     }
 
-    if (value != NULL)
+    while ((i < limit) && (stream->state != MB_JSON_stream_done) && (stream->state != MB_JSON_stream_error))
     {
-        MB_JSON_error local_error;
-        local_error.json = (const unsigned char *)value;
-        local_error.position = 0;
+        size_t start = i;
+        MB_JSON_bool ok = true;
 
-        if (buffer.offset < buffer.length)
+        switch (stream->state)
         {
-            local_error.position = buffer.offset;
+        case MB_JSON_stream_string:
+        case MB_JSON_stream_key_string:
+        {
+            MB_JSON_bool closed = false;
+            while ((i < limit) && !closed)
+            {
+                if (stream->escaped)
+                {
+                    stream->escaped = false;
+                }
+                else if (input[i] == '\\')
+                {
+                    stream->escaped = true;
+                }
+                else if (input[i] == '\"')
+                {
+                    closed = true;
+                }
+#if MB_JSON_FAST_SCAN
+                else
+                {
+                    /* copy the plain run at once */
+                    i = (size_t)(MB_JSON_skip_plain(input + i, input + limit) - input);
+                    continue;
+                }
+#endif
+                i++;
+            }
+            ok = MB_JSON_stream_append(stream, input + start, i - start) && (!closed || MB_JSON_stream_end_string(stream));
+            break;
         }
-        else if (buffer.length > 0)
+
+        case MB_JSON_stream_number:
+        case MB_JSON_stream_literal:
         {
-            local_error.position = buffer.length - 1;
+            MB_JSON_bool number = stream->state == MB_JSON_stream_number;
+            while ((i < limit) && (number ? MB_JSON_stream_is_number_char(input[i]) : MB_JSON_stream_is_literal_char(input[i])))
+            {
+                i++;
+            }
+            ok = MB_JSON_stream_append(stream, input + start, i - start);
+            if (ok && (i < limit))
+            {
+                /* the byte after the token is taken by the next state */
+                stream->token[stream->token_length] = '\0';
+                ok = number ? MB_JSON_stream_parse_token(stream, stream->item) : MB_JSON_stream_parse_literal(stream, stream->item);
+                MB_JSON_stream_end_value(stream);
+            }
+            break;
         }
 
-        if (return_parse_end != NULL)
+        default:
+            ok = MB_JSON_stream_structure(stream, input[i]);
+            i++;
+            break;
+        }
+
+        if (!ok)
         {
-            *return_parse_end = (const char *)local_error.json + local_error.position;
+            stream->state = MB_JSON_stream_error;
         }
+    }
 
-        MB_JSON_global_error = local_error;
+    stream->size += i;
+
+    if (consumed != NULL)
+    {
+        *consumed = i;
     }
 
-    return NULL;
-}
+    if ((stream->state != MB_JSON_stream_done) && (i < length))
+    {
+        stream->state = MB_JSON_stream_error; /* larger than max_size */
+    }
 
-/* Default options for MB_JSON_Parse */
-MB_JSON_PUBLIC(MB_JSON *)
-MB_JSON_Parse(const char *value)
-{
-    return MB_JSON_ParseWithOpts(value, 0, 0);
-}
+    if (stream->state == MB_JSON_stream_error)
+    {
+        return MB_JSON_STREAM_ERROR;
+    }
 
-MB_JSON_PUBLIC(MB_JSON *)
-MB_JSON_ParseWithLength(const char *value, size_t buffer_length)
-{
-    return MB_JSON_ParseWithLengthOpts(value, buffer_length, 0, 0);
+    return stream->state == MB_JSON_stream_done ? MB_JSON_STREAM_DONE : MB_JSON_STREAM_MORE;
 }
 
 #define MB_JSON_min(a, b) (((a) < (b)) ? (a) : (b))
@@ -1277,7 +2339,7 @@ size_t MB_JSON_SerializedBufferLength(const MB_JSON *const item, MB_JSON_bool fo
     return buf_len->size;
 }
 
-static unsigned char *MB_JSON_print(const MB_JSON *const item, MB_JSON_bool format, const MB_JSON_internal_hooks *const hooks)
+static unsigned char *MB_JSON_print(const MB_JSON *const item, MB_JSON_bool format, const MB_JSON_internal_hooks *const hooks, MB_JSON_trace_fn trace_fn, void *trace_arg)
 {
     static const size_t default_buffer_size = 256;
     MB_JSON_printbuffer buffer[1];
@@ -1290,6 +2352,8 @@ static unsigned char *MB_JSON_print(const MB_JSON *const item, MB_JSON_bool form
     buffer->length = default_buffer_size;
     buffer->format = format;
     buffer->hooks = *hooks;
+    buffer->trace_fn = trace_fn;
+    buffer->trace_arg = trace_arg;
     if (buffer->buffer == NULL)
     {
         goto fail;
@@ -1346,19 +2410,27 @@ fail:
 MB_JSON_PUBLIC(char *)
 MB_JSON_Print(const MB_JSON *item)
 {
-    return (char *)MB_JSON_print(item, true, &MB_JSON_global_hooks);
+    return (char *)MB_JSON_print(item, true, &MB_JSON_global_hooks, NULL, NULL);
 }
 
 MB_JSON_PUBLIC(char *)
 MB_JSON_PrintUnformatted(const MB_JSON *item)
 {
-    return (char *)MB_JSON_print(item, false, &MB_JSON_global_hooks);
+    return (char *)MB_JSON_print(item, false, &MB_JSON_global_hooks, NULL, NULL);
+}
+
+MB_JSON_PUBLIC(char *)
+MB_JSON_PrintTraced(const MB_JSON *item, MB_JSON_trace_fn trace_fn, void *arg)
+{
+    return (char *)MB_JSON_print(item, false, &MB_JSON_global_hooks, trace_fn, arg);
 }
 
 MB_JSON_PUBLIC(char *)
 MB_JSON_PrintBuffered(const MB_JSON *item, int prebuffer, MB_JSON_bool fmt)
 {
-    MB_JSON_printbuffer p = {0, 0, 0, 0, 0, 0, {0, 0, 0}};
+    MB_JSON_printbuffer p;
+
+    memset(&p, 0, sizeof(p));
 
     if (prebuffer < 0)
     {
@@ -1386,10 +2458,54 @@ MB_JSON_PrintBuffered(const MB_JSON *item, int prebuffer, MB_JSON_bool fmt)
     return (char *)p.buffer;
 }
 
+MB_JSON_PUBLIC(MB_JSON_bool)
+MB_JSON_PrintChunked(const MB_JSON *item, size_t chunk_size, const MB_JSON_bool format, MB_JSON_write_fn write_fn, void *arg)
+{
+    MB_JSON_printbuffer p;
+    MB_JSON_bool ret = false;
+
+    memset(&p, 0, sizeof(p));
+
+    if ((item == NULL) || (write_fn == NULL) || (chunk_size == 0))
+    {
+        return false;
+    }
+
+    p.buffer = (unsigned char *)MB_JSON_global_hooks.allocate(chunk_size);
+    if (!p.buffer)
+    {
+        return false;
+    }
+
+    p.length = chunk_size;
+    p.offset = 0;
+    p.noalloc = false;
+    p.format = format;
+    p.hooks = MB_JSON_global_hooks;
+    p.write_fn = write_fn;
+    p.write_arg = arg;
+
+    if (MB_JSON_print_value(item, &p))
+    {
+        MB_JSON_update_offset(&p);
+        ret = p.offset == 0 || write_fn(p.buffer, p.offset, arg);
+    }
+
+    /* the buffer may be reallocated or freed by MB_JSON_ensure */
+    if (p.buffer != NULL)
+    {
+        MB_JSON_global_hooks.deallocate(p.buffer);
+    }
+
+    return ret;
+}
+
 MB_JSON_PUBLIC(MB_JSON_bool)
 MB_JSON_PrintPreallocated(MB_JSON *item, char *buffer, const int length, const MB_JSON_bool format)
 {
-    MB_JSON_printbuffer p = {0, 0, 0, 0, 0, 0, {0, 0, 0}};
+    MB_JSON_printbuffer p;
+
+    memset(&p, 0, sizeof(p));
 
     if ((length < 0) || (buffer == NULL))
     {
@@ -1478,6 +2594,18 @@ static MB_JSON_bool MB_JSON_get_value_buffer_length(const MB_JSON *const item, M
         buf_len->size += 4;
         return true;
 
+    case MB_JSON_Number:
+    {
+        unsigned char number_buffer[26] = {0};
+        int length = MB_JSON_format_number(item->valuedouble, number_buffer);
+        if ((length < 0) || (length > (int)(sizeof(number_buffer) - 1)))
+        {
+            return false;
+        }
+        buf_len->size += (size_t)length;
+        return true;
+    }
+
     case MB_JSON_Raw:
     {
 
@@ -1505,7 +2633,34 @@ static MB_JSON_bool MB_JSON_get_value_buffer_length(const MB_JSON *const item, M
 }
 
 /* Render a value to text. */
+static MB_JSON_bool MB_JSON_print_item(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer);
+
 static MB_JSON_bool MB_JSON_print_value(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer)
+{
+    size_t key = 0;
+    size_t start = 0;
+
+    if ((item == NULL) || (output_buffer == NULL) || (output_buffer->trace_fn == NULL))
+    {
+        return MB_JSON_print_item(item, output_buffer);
+    }
+
+    start = output_buffer->offset;
+    key = output_buffer->trace_keyed ? output_buffer->trace_key : start;
+    output_buffer->trace_keyed = false;
+
+    output_buffer->trace_fn(item, key, start, 0, output_buffer->trace_arg);
+    if (!MB_JSON_print_item(item, output_buffer))
+    {
+        return false;
+    }
+    MB_JSON_update_offset(output_buffer);
+    output_buffer->trace_fn(item, key, start, output_buffer->offset, output_buffer->trace_arg);
+
+    return true;
+}
+
+static MB_JSON_bool MB_JSON_print_item(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer)
 {
     unsigned char *output = NULL;
 
@@ -1617,7 +2772,7 @@ static MB_JSON_bool MB_JSON_parse_array(MB_JSON *const item, MB_JSON_parse_buffe
     do
     {
         /* allocate next item */
-        MB_JSON *new_item = MB_JSON_New_Item(&(input_buffer->hooks));
+        MB_JSON *new_item = MB_JSON_parse_new_item(input_buffer);
         if (new_item == NULL)
         {
             goto fail; /* allocation failure */
@@ -1670,7 +2825,7 @@ success:
 fail:
     if (head != NULL)
     {
-        MB_JSON_Delete(head);
+        MB_JSON_parse_delete(input_buffer, head);
     }
 
     return false;
@@ -1895,7 +3050,7 @@ static MB_JSON_bool MB_JSON_parse_object(MB_JSON *const item, MB_JSON_parse_buff
     do
     {
         /* allocate next item */
-        MB_JSON *new_item = MB_JSON_New_Item(&(input_buffer->hooks));
+        MB_JSON *new_item = MB_JSON_parse_new_item(input_buffer);
         if (new_item == NULL)
         {
             goto fail; /* allocation failure */
@@ -1965,7 +3120,7 @@ success:
 fail:
     if (head != NULL)
     {
-        MB_JSON_Delete(head);
+        MB_JSON_parse_delete(input_buffer, head);
     }
 
     return false;
@@ -1979,13 +3134,13 @@ static MB_JSON_bool MB_JSON_get_object_buffer_length(const MB_JSON *const item,
     //'{' or "{\n"
     length = (size_t)(buf_len->format && current_item != NULL ? 2 : 1); 
 
+    buf_len->size += length;
+
     //do nothing for empty object
     if (current_item != NULL)
     {
         buf_len->depth++;
 
-        buf_len->size += length;
-
         while (current_item)
         {
             //'\t'
@@ -2075,6 +3230,8 @@ static MB_JSON_bool MB_JSON_print_object(const MB_JSON *const item, MB_JSON_prin
             }
 
             /* print key */
+            output_buffer->trace_key = output_buffer->offset;
+            output_buffer->trace_keyed = true;
             if (!MB_JSON_print_string_ptr((unsigned char *)current_item->string, output_buffer))
             {
                 return false;
@@ -2276,7 +3433,7 @@ static MB_JSON *MB_JSON_create_reference(const MB_JSON *item, const MB_JSON_inte
 
     memcpy(reference, item, sizeof(MB_JSON));
     reference->string = NULL;
-    reference->type |= MB_JSON_IsReference;
+    reference->type = (reference->type | MB_JSON_IsReference) & ~MB_JSON_IsArena;
     reference->next = reference->prev = NULL;
     return reference;
 }
@@ -3094,7 +4251,7 @@ MB_JSON_Duplicate(const MB_JSON *item, MB_JSON_bool recurse)
         goto fail;
     }
     /* Copy over all vars */
-    newitem->type = item->type & (~MB_JSON_IsReference);
+    newitem->type = item->type & ~(MB_JSON_IsReference | MB_JSON_IsArena | MB_JSON_ValueIsConst);
     newitem->valueint = item->valueint;
     newitem->valuedouble = item->valuedouble;
     if (item->valuestring)
@@ -3107,7 +4264,12 @@ MB_JSON_Duplicate(const MB_JSON *item, MB_JSON_bool recurse)
     }
     if (item->string)
     {
-        newitem->string = (item->type & MB_JSON_StringIsConst) ? item->string : (char *)MB_JSON_strdup((unsigned char *)item->string, &MB_JSON_global_hooks);
+        /* arena and in-situ keys go away with their memory, the copy gets its own */
+        if (item->type & (MB_JSON_IsArena | MB_JSON_ValueIsConst))
+        {
+            newitem->type &= ~MB_JSON_StringIsConst;
+        }
+        newitem->string = (newitem->type & MB_JSON_StringIsConst) ? item->string : (char *)MB_JSON_strdup((unsigned char *)item->string, &MB_JSON_global_hooks);
         if (!newitem->string)
         {
             goto fail;
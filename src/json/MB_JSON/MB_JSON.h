@@ -106,6 +106,9 @@ then using the MB_JSON_API_VISIBILITY flag to "export" the same symbols the way
 
 #define MB_JSON_IsReference 256
 #define MB_JSON_StringIsConst 512
+/* Set on items parsed into a MB_JSON_Arena, the item memory and its valuestring belong to the arena. */
+#define MB_JSON_IsArena 1024
+#define MB_JSON_ValueIsConst 2048
 
 /* The MB_JSON structure: */
 typedef struct MB_JSON
@@ -140,12 +143,42 @@ typedef struct MB_JSON_Hooks
 
 typedef int MB_JSON_bool;
 
+/* Receives the position of every item printed by MB_JSON_PrintTraced, once before its value is printed (end is 0) and once after.
+ * key is the offset of the quoted key, or start when the item is printed without one. */
+typedef void (*MB_JSON_trace_fn)(const MB_JSON *item, size_t key, size_t start, size_t end, void *arg);
+
+/* Block allocator that owns the items and strings of a parsed tree, see MB_JSON_ParseWithArena. */
+typedef struct MB_JSON_Arena MB_JSON_Arena;
+
+/* Resumable parser that builds the tree from the slices given to MB_JSON_StreamFeed. */
+typedef struct MB_JSON_Stream MB_JSON_Stream;
+
+/* MB_JSON_StreamFeed results */
+#define MB_JSON_STREAM_ERROR -1
+#define MB_JSON_STREAM_MORE 0
+#define MB_JSON_STREAM_DONE 1
+
+/* Receives the printed text from MB_JSON_PrintChunked, return 0 to stop printing. */
+typedef MB_JSON_bool (*MB_JSON_write_fn)(const unsigned char *data, size_t len, void *arg);
+
 /* Limits how deeply nested arrays/objects can be before MB_JSON rejects to parse them.
  * This is to prevent stack overflows. */
 #ifndef MB_JSON_NESTING_LIMIT
 #define MB_JSON_NESTING_LIMIT 1000
 #endif
 
+/* Parse and print the common short numbers without strtod/sprintf, set to 0 to always use libc.
+ * The results are identical to libc for the numbers taken by the fast paths. */
+#ifndef MB_JSON_FAST_NUMBER
+#define MB_JSON_FAST_NUMBER 1
+#endif
+
+/* Skip plain string characters and whitespace a word (or a SSE2/NEON vector on host) at a time,
+ * set to 0 to scan byte by byte. */
+#ifndef MB_JSON_FAST_SCAN
+#define MB_JSON_FAST_SCAN 1
+#endif
+
 /* returns the version of MB_JSON as a string */
 MB_JSON_PUBLIC(const char*) MB_JSON_Version(void);
 
@@ -164,15 +197,44 @@ MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ParseWithLength(const char *value, size_t buff
 MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ParseWithOpts(const char *value, const char **return_parse_end, MB_JSON_bool require_null_terminated);
 MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated);
 
+/* Create an arena that hands out memory from blocks of block_size bytes (taken from the MB_JSON hooks). */
+MB_JSON_PUBLIC(MB_JSON_Arena *) MB_JSON_ArenaCreate(size_t block_size);
+/* Rewind the arena for the next parse, keeping its newest block. Every tree parsed into it must have been deleted first. */
+MB_JSON_PUBLIC(void) MB_JSON_ArenaReset(MB_JSON_Arena *arena);
+MB_JSON_PUBLIC(void) MB_JSON_ArenaDestroy(MB_JSON_Arena *arena);
+/* Same as MB_JSON_ParseWithOpts but the items, keys and strings are carved from the arena instead of being allocated one by one.
+ * The tree is still released with MB_JSON_Delete, which then only frees the items added after parsing, the arena memory is reclaimed by MB_JSON_ArenaReset.
+ * On failure the partially parsed items stay in the arena until it is reset. */
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ParseWithArena(const char *value, const char **return_parse_end, MB_JSON_bool require_null_terminated, MB_JSON_Arena *arena);
+/* Destructive parse, the keys and strings are decoded in place and point into value, which must outlive the tree.
+ * Only the items are allocated (from the arena when given). value is left unusable as JSON, also on failure. */
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ParseInSitu(char *value, const char **return_parse_end, MB_JSON_bool require_null_terminated, MB_JSON_Arena *arena);
+
+/* Create a resumable parser. max_depth limits the nesting (0 for MB_JSON_NESTING_LIMIT), max_size the bytes of one JSON (0 for no limit). */
+MB_JSON_PUBLIC(MB_JSON_Stream *) MB_JSON_StreamCreate(size_t max_depth, size_t max_size);
+/* Parse the next slice of the JSON text, the slices can be split anywhere. Returns MB_JSON_STREAM_MORE until the value is complete,
+ * then MB_JSON_STREAM_DONE with *consumed (optional) telling where it ended in the last slice. A number or literal at the root completes at the first byte after it.
+ * Only the string, number or literal that spans the slices is kept, the tree is built as the data arrives. */
+MB_JSON_PUBLIC(int) MB_JSON_StreamFeed(MB_JSON_Stream *stream, const char *data, size_t length, size_t *consumed);
+/* Returns the completed tree, which the caller then owns, and rewinds the parser for the next JSON. NULL when MB_JSON_StreamFeed has not returned MB_JSON_STREAM_DONE. */
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_StreamTake(MB_JSON_Stream *stream);
+/* Drop the partially parsed tree (e.g. after an error) and rewind the parser. */
+MB_JSON_PUBLIC(void) MB_JSON_StreamReset(MB_JSON_Stream *stream);
+MB_JSON_PUBLIC(void) MB_JSON_StreamDestroy(MB_JSON_Stream *stream);
+
 /* Render a MB_JSON entity to text for transfer/storage. */
 MB_JSON_PUBLIC(char *) MB_JSON_Print(const MB_JSON *item);
 /* Render a MB_JSON entity to text for transfer/storage without any formatting. */
 MB_JSON_PUBLIC(char *) MB_JSON_PrintUnformatted(const MB_JSON *item);
+/* Same as MB_JSON_PrintUnformatted but reports where each item ends up in the text. */
+MB_JSON_PUBLIC(char *) MB_JSON_PrintTraced(const MB_JSON *item, MB_JSON_trace_fn trace_fn, void *arg);
 /* Render a MB_JSON entity to text using a buffered strategy. prebuffer is a guess at the final size. guessing well reduces reallocation. fmt=0 gives unformatted, =1 gives formatted */
 MB_JSON_PUBLIC(char *) MB_JSON_PrintBuffered(const MB_JSON *item, int prebuffer, MB_JSON_bool fmt);
 /* Render a MB_JSON entity to text using a buffer already allocated in memory with given length. Returns 1 on success and 0 on failure. */
 /* NOTE: MB_JSON is not always 100% accurate in estimating how much memory it will use, so to be safe allocate 5 bytes more than you actually need */
 MB_JSON_PUBLIC(MB_JSON_bool) MB_JSON_PrintPreallocated(MB_JSON *item, char *buffer, const int length, const MB_JSON_bool format);
+/* Render a MB_JSON entity to text in pieces of at most chunk_size - 1 bytes passed to write_fn, a single string longer than that grows the buffer. Returns 1 on success and 0 on failure or when write_fn returns 0. */
+MB_JSON_PUBLIC(MB_JSON_bool) MB_JSON_PrintChunked(const MB_JSON *item, size_t chunk_size, const MB_JSON_bool format, MB_JSON_write_fn write_fn, void *arg);
 /* Delete a MB_JSON entity and all subentities. */
 MB_JSON_PUBLIC(void) MB_JSON_Delete(MB_JSON *item);
 
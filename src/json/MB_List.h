@@ -105,7 +105,7 @@ public:
         current = 0;
     }
 
-    size_t size()
+    size_t size() const
     {
         return current;
     }
@@ -117,6 +117,13 @@ public:
         return arr[0];
     }
 
+    const T &operator[](int index) const
+    {
+        if (index < current && index >= 0)
+            return arr[index];
+        return arr[0];
+    }
+
     void swap(MB_List &item)
     {
         MB_List temp;
@@ -94,6 +94,15 @@
 #define ESP8266_USE_EXTERNAL_HEAP
 #endif
 
+// The size of inline buffer for short string (keys, IDs and header fragments), 0 to disable
+#if !defined(MB_STRING_SSO_SIZE)
+#if defined(__AVR__) || defined(ESP8266_USE_EXTERNAL_HEAP)
+#define MB_STRING_SSO_SIZE 0
+#else
+#define MB_STRING_SSO_SIZE 16
+#endif
+#endif
+
 #if defined(ESP8266) || defined(ESP32)
 #define MBSTRING_FLASH_MCR FPSTR
 #elif defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT)
@@ -1026,8 +1035,10 @@ public:
 
         size_t slen = length();
 
-        if (n > strlen(cstr))
-            n = strlen(cstr);
+        // the source may not be null terminated, do not read beyond n
+        const char *end = (const char *)memchr(cstr, 0, n);
+        if (end)
+            n = end - cstr;
 
         if (_reserve(slen + n, false))
         {
@@ -1679,25 +1690,45 @@ private:
         concat(cstr, strlen(cstr));
     }
 
+public:
+    // Take over the rhs buffer (copied when it's short) and leave rhs empty
     void move(MB_String &rhs)
     {
+        // the inline buffer can't be taken
+        if (rhs.isInline())
+        {
+            *this = rhs;
+            rhs.clear();
+            return;
+        }
+
         if (buf)
         {
             if (bufLen >= rhs.bufLen)
             {
                 strcpy(buf, rhs.buf);
-                bufLen = rhs.bufLen;
-                rhs.bufLen = 0;
+                rhs.clear();
                 return;
             }
             else
             {
-                free(buf);
+                allocate(0, false);
             }
         }
         buf = rhs.buf;
         bufLen = rhs.bufLen;
         rhs.buf = NULL;
+        rhs.bufLen = 0;
+    }
+
+private:
+    bool isInline() const
+    {
+#if MB_STRING_SSO_SIZE > 0
+        return buf == sso;
+#else
+        return false;
+#endif
     }
 
     void allocate(size_t len, bool shrink)
@@ -1705,13 +1736,34 @@ private:
 
         if (len == 0)
         {
-            if (buf)
+            if (buf && !isInline())
                 free(buf);
             buf = NULL;
             bufLen = 0;
             return;
         }
 
+#if MB_STRING_SSO_SIZE > 0
+        // use the inline buffer for short string
+        if (len <= MB_STRING_SSO_SIZE && (!buf || isInline()))
+        {
+            if (!buf)
+                sso[0] = '\0';
+            buf = sso;
+            bufLen = MB_STRING_SSO_SIZE;
+            return;
+        }
+
+        // move the short string out of the inline buffer
+        const char *inlineStr = NULL;
+        if (isInline())
+        {
+            inlineStr = sso;
+            buf = NULL;
+            bufLen = 0;
+        }
+#endif
+
         if (len > bufLen || shrink)
         {
 
@@ -1758,6 +1810,11 @@ private:
             ESP.resetHeap();
 #endif
         }
+
+#if MB_STRING_SSO_SIZE > 0
+        if (inlineStr && buf)
+            strcpy(buf, inlineStr);
+#endif
     }
 
     MB_String &copy(const char *cstr, size_t length)
@@ -1782,9 +1839,15 @@ private:
         if (shrink)
             allocate(newlen, true);
         else if (newlen > bufLen)
-            allocate(newlen, false);
+        {
+            // grow by 1.5 times at least to keep the repeated appends from reallocating every time
+            if (bufLen > 0 && newlen < bufLen + bufLen / 2)
+                allocate(getReservedLen(bufLen + bufLen / 2), false);
+            else
+                allocate(newlen, false);
+        }
 
-        return newlen <= bufLen;
+        return getReservedLen(len) <= bufLen;
     }
 
     int strpos(const char *haystack, const char *needle, int offset) const
@@ -2028,6 +2091,9 @@ private:
 
     char *buf = NULL;
     size_t bufLen = 0;
+#if MB_STRING_SSO_SIZE > 0
+    char sso[MB_STRING_SSO_SIZE];
+#endif
 };
 
 inline MB_String operator+(const MB_String &lhs, const MB_String &rhs)